@@ -10,6 +10,11 @@
 #include <printer_concepts.h>
 #include "external/poolstl/poolstl.hpp"
 #include "external/glob/glob/glob.h"
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <thread>
 
 using namespace ::csvsuite::cli;
 using namespace ::csvsuite::cli::compare;
@@ -23,14 +28,18 @@ namespace csvjoin {
         std::string &date_fmt = kwarg("date-format", "Specify an strptime date format string like \"%m/%d/%Y\".").set_default(R"(%m/%d/%Y)");
         std::string &datetime_fmt = kwarg("datetime-format", "Specify an strptime datetime format string like \"%m/%d/%Y %I:%M %p\".").set_default(R"(%m/%d/%Y %I:%M %p)");
         bool & no_leading_zeroes = flag("no-leading-zeroes", "Do not convert a numeric value with leading zeroes to a number.");
-        std::string &columns = kwarg("c,columns", "The column name(s) on which to join. Should be either one name (or index) or a comma-separated list with one name (or index) for each file, in the same order that the files were specified. May also be left unspecified, in which case the two files will be joined sequentially without performing any matching.").set_default("");
+        std::string &columns = kwarg("c,columns", "The column name(s) on which to join. Should be either one name (or index) or a comma-separated list with one name (or index) for each file, in the same order that the files were specified. Names (or indices) joined by \"+\" make a composite key, e.g. \"a+b,c+d\". May also be left unspecified, in which case the two files will be joined sequentially without performing any matching.").set_default("");
         bool &outer_join = flag("outer", "Perform a full outer join, rather than the default inner join.");
         bool &honest_outer_join = flag("honest-outer", "Typify outer joins result before printing.");
         bool &left_join = flag("left", "Perform a left outer join, rather than the default inner join. If more than two files are provided this will be executed as a sequence of left outer joins, starting at the left.");
         bool &right_join = flag("right", "Perform a right outer join, rather than the default inner join. If more than two files are provided this will be executed as a sequence of right outer joins, starting at the right.");
         bool &no_inference = flag("I,no-inference", "Disable type inference (and --locale, --date-format, --datetime-format, --no-leading-zeroes) when parsing the input.");
+        unsigned long &infer_rows = kwarg("infer-rows", "Infer column types from the first N data rows, then test the rest of the rows against the types they left possible only (0: from all the rows). A contradicting value falls back to the next such type, text last.").set_default(0ul);
         bool &date_lib_parser = flag("date-lib-parser", "Use date library as Dates and DateTimes parser backend instead compiler-supported").set_default(true);
         bool & asap = flag("ASAP","Print result output stream as soon as possible.").set_default(true);
+        bool & presorted = flag("presorted", "The files are sorted on the join columns: merge them instead of hashing, keeping only rows of the current key.");
+        std::string & memory_limit = kwarg("memory-limit", "Keep at most this much of a join in memory, e.g. 512M or 4G, partitioning the files by their keys into temporary files (default: no limit).").set_default(std::string{});
+        std::string & temp_dir = kwarg("temp-dir", "Directory of the temporary files of --memory-limit (default: the system temporary directory).").set_default(std::string{});
 
         void welcome() final {
             std::cout << "\nExecute a SQL-like join to merge CSV files on a specified column or columns.\n\n";
@@ -113,6 +122,437 @@ namespace csvjoin::detail {
             std::is_move_assignable<reader_fake<notrimming_reader_type, typename notrimming_reader_type::template
             typed_span<csv_co::quoted>>>::value);
 
+    /// A row of a join result kept as the numbers of its left and right rows rather than as strings
+    struct joined_row {
+        std::size_t left;
+        std::size_t right;
+    };
+    /// A missing row of a joined row: its cells are empty
+    inline constexpr std::size_t no_row = static_cast<std::size_t>(-1);
+
+    /// Whether the column is one of the excluded ones
+    inline bool is_excluded(std::vector<unsigned> const & excluded, unsigned column) {
+        return std::find(excluded.begin(), excluded.end(), column) != excluded.end();
+    }
+
+    /// Columns of the joined tables: a joined row has all the left cells and the right ones but the excluded columns
+    struct join_shape {
+        std::size_t left_cols;
+        std::size_t right_cols;
+        std::vector<unsigned> excluded;
+    };
+
+    /// Calls f for every cell of a joined row. A missing row gives empty strings instead of its cells.
+    template <class LeftTable, class RightRows, class F>
+    void for_each_joined_cell(LeftTable & left, RightRows const & right, join_shape const & shape, joined_row row, F && f) {
+        static std::string const empty;
+        if (row.left == no_row) {
+            for (std::size_t c = 0; c < shape.left_cols; ++c)
+                f(empty);
+        } else {
+            for (auto const & cell : left[row.left])
+                f(cell);
+        }
+        for (unsigned c = 0; c < shape.right_cols; ++c) {
+            if (is_excluded(shape.excluded, c))
+                continue;
+            if (row.right == no_row)
+                f(empty);
+            else
+                f(right[row.right][c]);
+        }
+    }
+
+    /// A key index of this many keys no longer fits a core's cache: the misses are worth a Bloom filter
+    inline constexpr std::size_t bloom_filter_min_keys = 8192;
+
+    /// Rows a probe task looks up at a time
+    inline constexpr std::size_t probe_chunk_rows = 4096;
+
+    /// Looks the keys key_of(0) ... key_of(rows - 1) up in the key index, concurrently. The joined rows follow the
+    /// order of the keys, then the input order of the matching rows. Unmatched keys are kept with no right row if
+    /// keep_unmatched, and the rows of the index having a match are flagged in matched, if given.
+    /// If a sample of the keys mostly misses a large index, the keys are checked with a Bloom filter of it first.
+    template <class KeyOf, class Index>
+    std::vector<joined_row> probe_keys(std::size_t rows, KeyOf const & key_of, Index const & index, bool keep_unmatched
+                                       , std::vector<unsigned char> * matched = nullptr) {
+        if (!rows)
+            return {};
+
+        std::optional<::csvsuite::cli::hash::blocked_bloom_filter> filter;
+        if (index.size() >= bloom_filter_min_keys) {
+            auto const sample = std::min<std::size_t>(rows, 1024);
+            std::size_t hits = 0;
+            for (std::size_t i = 0; i < sample; ++i)
+                hits += index.find(key_of(i * rows / sample)) != index.cend();
+            if (2 * hits < sample)
+                filter.emplace(index.key_filter());
+        }
+
+        std::vector<std::span<std::size_t const>> found(rows);
+        std::vector<std::size_t> chunks;
+        for (std::size_t r = 0; r < rows; r += probe_chunk_rows)
+            chunks.push_back(r);
+        std::for_each(poolstl::par, chunks.begin(), chunks.end(), [&](std::size_t first) {
+            for (auto r = first, last = std::min(rows, first + probe_chunk_rows); r < last; ++r) {
+                auto const key = key_of(r);
+                auto const h = index.key_hash(key);
+                if (filter && !filter->may_contain(h))
+                    continue;
+                if (auto search = index.find(key, h); search != index.cend())
+                    found[r] = search->second.ids();
+            }
+        });
+
+        std::size_t total = 0;
+        for (auto const & ids : found)
+            total += ids.empty() ? keep_unmatched : ids.size();
+        std::vector<joined_row> result;
+        result.reserve(total);
+        for (std::size_t r = 0; r < rows; ++r) {
+            if (found[r].empty() && keep_unmatched)
+                result.push_back({r, no_row});
+            for (auto id : found[r]) {
+                result.push_back({r, id});
+                if (matched)
+                    (*matched)[id] = 1;
+            }
+        }
+        return result;
+    }
+
+    /// Looks the keys of the table rows, their cells in the key columns, up in the key index, as probe_keys does
+    template <class Table, class Index>
+    std::vector<joined_row> probe(Table & table, std::size_t rows, std::vector<unsigned> const & columns, Index const & index
+                                  , bool keep_unmatched, std::vector<unsigned char> * matched = nullptr) {
+        using key_type = typename Index::rows_type::element_type;
+        return probe_keys(rows, [&](std::size_t r) {
+            return row_key<key_type, decltype(table[r])>(table[r], columns);
+        }, index, keep_unmatched, matched);
+    }
+
+    /// Joined rows of a probe made by the right table into the index of the left one have the sides swapped and follow
+    /// the right rows. Puts the sides back in place and restores the order of a probe made from the left.
+    inline std::vector<joined_row> swap_sides(std::vector<joined_row> const & rows, std::size_t left_rows) {
+        std::vector<std::size_t> starts(left_rows + 1);
+        for (auto const & row : rows)
+            ++starts[row.right + 1];
+        std::partial_sum(starts.begin(), starts.end(), starts.begin());
+        std::vector<joined_row> result(rows.size());
+        for (auto const & row : rows)
+            result[starts[row.right]++] = {row.right, row.left};
+        return result;
+    }
+
+    /// Rows of a multi-file join kept as the numbers of the rows they take from every file joined so far, no_row for
+    /// a file they have no row of
+    class row_tuples {
+    public:
+        explicit row_tuples(std::size_t files = 1) : files_(files) {}
+
+        /// Every row of a single file
+        static row_tuples of_rows(std::size_t rows) {
+            row_tuples result;
+            result.ids_.resize(rows);
+            std::iota(result.ids_.begin(), result.ids_.end(), std::size_t{0});
+            return result;
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return ids_.size() / files_; }
+        std::span<std::size_t const> operator[](std::size_t i) const noexcept {
+            return {ids_.data() + i * files_, files_};
+        }
+
+        /// The tuples joined with the rows of one more file: the left of a joined row is a tuple, the right is a row
+        /// of the file
+        [[nodiscard]] row_tuples extended(std::vector<joined_row> const & rows) const {
+            row_tuples result(files_ + 1);
+            result.ids_.reserve(rows.size() * result.files_);
+            for (auto const & row : rows) {
+                if (row.left == no_row)
+                    result.ids_.insert(result.ids_.end(), files_, no_row);
+                else {
+                    auto const tuple = (*this)[row.left];
+                    result.ids_.insert(result.ids_.end(), tuple.begin(), tuple.end());
+                }
+                result.ids_.push_back(row.right);
+            }
+            return result;
+        }
+
+    private:
+        std::size_t files_;
+        std::vector<std::size_t> ids_;
+    };
+
+    /// A file of a multi-file join: the owner of its rows and the rows, if it has any, its column count, and its
+    /// columns left out of the joined rows
+    template <class Rows>
+    struct joined_table {
+        std::shared_ptr<void const> owner;
+        Rows const * rows;
+        std::size_t cols;
+        std::vector<unsigned> excluded;
+    };
+
+    /// Calls f for every cell of a row tuple. A missing row gives empty strings instead of its cells.
+    template <class Rows, class F>
+    void for_each_tuple_cell(std::vector<joined_table<Rows>> const & tables, std::span<std::size_t const> ids, F && f) {
+        static std::string const empty;
+        for (std::size_t t = 0; t < tables.size(); ++t) {
+            auto const & table = tables[t];
+            for (unsigned c = 0; c < table.cols; ++c) {
+                if (is_excluded(table.excluded, c))
+                    continue;
+                if (ids[t] == no_row)
+                    f(empty);
+                else
+                    f((*table.rows)[ids[t]][c]);
+            }
+        }
+    }
+
+    /// Rows of a reader taken one by one from a thread running reader.run_rows(), so that two readers can be walked
+    /// side by side. The rows are handed over in batches, and at most two batches are kept at a time.
+    template <class Reader, class Elem>
+    class row_pump {
+    public:
+        using group_type = ::csvsuite::cli::compare::cell_arena_MxN<Elem>;
+
+        template <class Args>
+        row_pump(Reader & reader, Args const & args) {
+            reader.skip_rows(0);
+            skip_lines(reader, args);
+            columns_ = obtain_header_and_<skip_header>(reader, args).size();
+            batch_ = ready_ = filling_ = group_type(columns_);
+            worker_ = std::thread([this, &reader] { produce(reader); });
+        }
+        row_pump(row_pump const &) = delete;
+        row_pump & operator=(row_pump const &) = delete;
+        ~row_pump() {
+            {
+                std::lock_guard lock(mutex_);
+                stop_ = true;
+            }
+            cv_.notify_all();
+            worker_.join();
+        }
+
+        /// Moves to the next row, false at the end. A failure of the reader is rethrown here.
+        bool next() {
+            if (batch_.rows() && ++pos_ < batch_.rows())
+                return true;
+            std::unique_lock lock(mutex_);
+            cv_.wait(lock, [this] { return full_ || done_; });
+            if (!full_) {
+                if (error_)
+                    std::rethrow_exception(error_);
+                batch_.clear();
+                return false;
+            }
+            std::swap(batch_, ready_);
+            full_ = false;
+            pos_ = 0;
+            lock.unlock();
+            cv_.notify_all();
+            return true;
+        }
+
+        [[nodiscard]] Elem key(unsigned column) const {
+            return batch_[pos_][column];
+        }
+        [[nodiscard]] group_type group() const {
+            return group_type(columns_);
+        }
+        /// Copies the current row to a group
+        void keep(group_type & group) const {
+            group.append(batch_[pos_]);
+        }
+
+    private:
+        struct stopped {};
+
+        void produce(Reader & reader) {
+            try {
+                reader.run_rows([&](auto & span) {
+                    filling_.append(span);
+                    if (filling_.rows() == batch_rows)
+                        hand_over();
+                });
+                if (filling_.rows())
+                    hand_over();
+            } catch (stopped const &) {
+            } catch (...) {
+                std::lock_guard lock(mutex_);
+                error_ = std::current_exception();
+            }
+            {
+                std::lock_guard lock(mutex_);
+                done_ = true;
+            }
+            cv_.notify_all();
+        }
+
+        void hand_over() {
+            std::unique_lock lock(mutex_);
+            cv_.wait(lock, [this] { return !full_ || stop_; });
+            if (stop_)
+                throw stopped{};
+            std::swap(filling_, ready_);
+            full_ = true;
+            lock.unlock();
+            cv_.notify_all();
+            filling_.clear();
+        }
+
+        static constexpr std::size_t batch_rows = 1024;
+        std::size_t columns_ {0};
+        std::size_t pos_ {0};
+        group_type batch_;
+        group_type ready_;
+        group_type filling_;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        bool full_ {false};
+        bool done_ {false};
+        bool stop_ {false};
+        std::exception_ptr error_;
+        std::thread worker_;
+    };
+
+    /// Rows of the table of a previous join stage, walked as a row_pump is
+    template <class Table, class Elem>
+    class table_cursor {
+    public:
+        using group_type = std::vector<typename Table::value_type>;
+
+        explicit table_cursor(Table const & table) : table_(table) {}
+
+        bool next() {
+            return ++pos_ <= table_.size();
+        }
+        [[nodiscard]] Elem key(unsigned column) const {
+            return Elem{table_[pos_ - 1][column]};
+        }
+        [[nodiscard]] group_type group() const {
+            return {};
+        }
+        void keep(group_type & group) const {
+            group.push_back(table_[pos_ - 1]);
+        }
+
+    private:
+        Table const & table_;
+        std::size_t pos_ {0};
+    };
+
+    /// Joins two sources sorted on their join columns, a group of rows having the same key at a time, so that only
+    /// the current groups are kept. The joined rows of every pair of groups are given to emit(left group, right group,
+    /// rows). Unmatched rows are kept as the join type wants them. Throws if a source turns out to be out of order.
+    template <class Left, class Right, class Compare, class Emit>
+    void merge_join(Left & left, unsigned left_column, Right & right, unsigned right_column, Compare const & compare
+                    , bool comparable, bool keep_left, bool keep_right, std::array<std::string, 2> const & names, Emit && emit) {
+        auto cmp = [&compare](auto const & a, auto const & b) {
+            int result;
+            std::visit([&](auto & c_cmp) { result = c_cmp(a, b); }, compare);
+            return result;
+        };
+
+        auto left_group = left.group();
+        auto right_group = right.group();
+        std::size_t left_rows = 0, right_rows = 0;
+        std::size_t left_row = 0, right_row = 0;
+        bool left_pending = left.next(), right_pending = right.next();
+        decltype(left.key(left_column)) left_key{};
+        decltype(right.key(right_column)) right_key{};
+
+        // Takes the rows of the next key group of a source, false at the end of the source
+        auto take_group = [&](auto & source, unsigned column, auto & group, std::size_t & rows, std::size_t & row
+                              , bool & pending, auto & key, std::string const & name) {
+            group.clear();
+            rows = 0;
+            if (!pending)
+                return false;
+            key = source.key(column);
+            do {
+                source.keep(group);
+                ++rows;
+                ++row;
+                pending = source.next();
+                if (!pending || !comparable)
+                    break;
+                auto const c = cmp(key, source.key(column));
+                if (c > 0)
+                    throw std::runtime_error("csvjoin: error: " + name + " is not sorted on the join column (data row "
+                                             + std::to_string(row + 1) + ").");
+                if (c < 0)
+                    break;
+            } while (true);
+            return true;
+        };
+
+        std::vector<joined_row> rows;
+        bool has_left = take_group(left, left_column, left_group, left_rows, left_row, left_pending, left_key, names[0]);
+        bool has_right = take_group(right, right_column, right_group, right_rows, right_row, right_pending, right_key, names[1]);
+        while (has_left || has_right) {
+            int const c = !has_left ? 1 : (!has_right || !comparable) ? -1 : cmp(left_key, right_key);
+            rows.clear();
+            if (c == 0) {
+                for (std::size_t l = 0; l < left_rows; ++l)
+                    for (std::size_t r = 0; r < right_rows; ++r)
+                        rows.push_back({l, r});
+            } else if (c < 0 && keep_left) {
+                for (std::size_t l = 0; l < left_rows; ++l)
+                    rows.push_back({l, no_row});
+            } else if (c > 0 && keep_right) {
+                for (std::size_t r = 0; r < right_rows; ++r)
+                    rows.push_back({no_row, r});
+            }
+            if (!rows.empty())
+                emit(left_group, right_group, rows);
+            if (c <= 0)
+                has_left = take_group(left, left_column, left_group, left_rows, left_row, left_pending, left_key, names[0]);
+            if (c >= 0)
+                has_right = take_group(right, right_column, right_group, right_rows, right_row, right_pending, right_key, names[1]);
+        }
+    }
+
+    /// A grace hash join deals the rows out by the hash bits above those of the key index slots and below those of
+    /// the key index partitions, a few more bits at every level
+    inline constexpr unsigned grace_first_bit = 32;
+    inline constexpr unsigned grace_last_bit = 56;
+    inline constexpr unsigned grace_max_bits = 8;
+
+    inline std::size_t grace_partition(std::uint64_t h, unsigned shift, unsigned bits) noexcept {
+        return static_cast<std::size_t>(h >> shift) & ((std::size_t{1} << bits) - 1);
+    }
+
+    /// A header name as a CSV cell
+    inline std::string csv_quoted(std::string const & name) {
+        if (name.find_first_of(",\"\r\n") == std::string::npos)
+            return name;
+        std::string result = "\"";
+        for (auto c : name) {
+            if (c == '"')
+                result += '"';
+            result += c;
+        }
+        return result + '"';
+    }
+
+    /// Writes cells as a CSV row. The cells keep the form they had in their source, quotes included.
+    template <class Row>
+    void write_csv_row(std::ostream & os, Row const & row) {
+        bool first = true;
+        for (auto const & cell : row) {
+            if (!first)
+                os << ',';
+            first = false;
+            os << std::string(cell);
+        }
+        os << '\n';
+    }
+
     auto parse_join_column_names(auto &&join_string) {
         std::istringstream stream(join_string);
         std::vector<std::string> result;
@@ -121,9 +561,19 @@ namespace csvjoin::detail {
         return result;
     }
 
+    /// The column names (or indices) of a composite key "a+b"
+    auto parse_key_column_names(std::string const & key) {
+        std::istringstream stream(key);
+        std::vector<std::string> result;
+        for (std::string word; std::getline(stream, word, '+');)
+            result.push_back(word);
+        return result;
+    }
+
     template <class OS>
     class printer {
         OS &os;
+        std::size_t joined_lines {0};
 
     public:
         explicit printer(OS &os = std::cout) : os(os) {}
@@ -174,6 +624,48 @@ namespace csvjoin::detail {
             }
         }
 
+        /// Prints join results straight from the cells of the joined tables. Line numbers go on across the calls.
+        template <class LeftTable, class RightRows>
+        void write(LeftTable & left, RightRows const & right, join_shape const & shape, std::vector<joined_row> const & rows
+                   , auto && types_n_blanks, auto && args) {
+            using elem_type = typename RightRows::element_type::template rebind<csv_co::unquoted>::other;
+            for (auto const & row : rows) {
+                if (args.linenumbers)
+                    os << ++joined_lines << ',';
+                auto col = 0u;
+                for_each_joined_cell(left, right, shape, row, [&](auto const & cell) {
+                    if (col)
+                        os << ',';
+                    if constexpr (std::is_same_v<std::decay_t<decltype(cell)>, std::string>)
+                        print_func(elem_type{cell}, col++, types_n_blanks, args);
+                    else
+                        print_func(cell.operator elem_type const&(), col++, types_n_blanks, args);
+                });
+                print_LF(os);
+            }
+        }
+
+        /// Prints the row tuples of a multi-file join straight from the cells of its files
+        template <class Rows>
+        void write(std::vector<joined_table<Rows>> const & tables, row_tuples const & tuples, auto && types_n_blanks
+                   , auto && args) {
+            using elem_type = typename Rows::element_type::template rebind<csv_co::unquoted>::other;
+            for (std::size_t i = 0; i < tuples.size(); ++i) {
+                if (args.linenumbers)
+                    os << ++joined_lines << ',';
+                auto col = 0u;
+                for_each_tuple_cell(tables, tuples[i], [&](auto const & cell) {
+                    if (col)
+                        os << ',';
+                    if constexpr (std::is_same_v<std::decay_t<decltype(cell)>, std::string>)
+                        print_func(elem_type{cell}, col++, types_n_blanks, args);
+                    else
+                        print_func(cell.operator elem_type const&(), col++, types_n_blanks, args);
+                });
+                print_LF(os);
+            }
+        }
+
         // Pure single file in input
         using ts_n_blanks_type = std::tuple<std::vector<::csvsuite::cli::column_type>, std::vector<unsigned char>>;
         template<CsvReaderConcept R>
@@ -251,7 +743,7 @@ namespace csvjoin::detail {
         using namespace csv_co;
         using reader_type = std::variant_alternative_t<0, typename std::decay_t<decltype(deq)>::value_type>;
         using args_type = std::decay_t<decltype(args)>;
-        std::deque<unsigned> c_ids;
+        std::deque<std::vector<unsigned>> c_ids;
         std::deque<std::vector<std::string>> headers;
         std::deque<std::tuple<std::vector<column_type>, std::vector<unsigned char>>> ts_n_blanks;
 
@@ -263,21 +755,22 @@ namespace csvjoin::detail {
         #include "include/csvjoin/compare_composers.h"
         #include "include/csvjoin/cycle_cleanup.h"
         #include "include/csvjoin/union_join.h"
-        #include "include/csvjoin/inner_join.h"
-        #include "include/csvjoin/left_right_join.h"
-        #include "include/csvjoin/outer_join.h"
+        #include "include/csvjoin/joined_rows.h"
+        #include "include/csvjoin/hash_join.h"
+        #include "include/csvjoin/presorted_join.h"
+        #include "include/csvjoin/grace_join.h"
 
         if (deq.empty())
             return;
 
         if (c_ids.empty())  // column ids are unspecified : UNION
             union_join();
-        else if (!args.outer_join && !args.left_join && !args.right_join)        // just -c 1
-            inner_join();
-        else if (args.left_join || args.right_join)
-            left_or_right_join();
+        else if (args.presorted)
+            presorted_join();
+        else if (auto const limit = memory_limit(args); limit && !fits_in_memory(limit))
+            grace_join(limit);
         else
-            outer_join();
+            hash_join();
 
         auto print_results = [&] {
             std::ostringstream oss;
@@ -285,9 +778,12 @@ namespace csvjoin::detail {
             printer p(oss_);
             struct non_typed_output {};
             p.write(headers[0], non_typed_output{}, args);
-            std::visit([&](auto && arg){
-                p.write(arg, ts_n_blanks[0], args);
-            }, deq.front());
+            if (late_output)
+                late_output(oss_);
+            else
+                std::visit([&](auto && arg){
+                    p.write(arg, ts_n_blanks[0], args);
+                }, deq.front());
             if (!args.asap)
                 std::cout << oss.str();
         };
@@ -306,6 +802,15 @@ namespace csvjoin::detail {
 
         if (!args.outer_join and args.honest_outer_join)
             throw std::runtime_error("You cannot provide honest-outer flag without outer joins.");
+
+        if (args.presorted and args.columns.empty())
+            throw std::runtime_error("You must provide join column names when performing a presorted join.");
+
+        if (args.presorted and args.honest_outer_join)
+            throw std::runtime_error("You cannot provide honest-outer flag for a presorted join.");
+
+        if (args.presorted and args.columns.find('+') != std::string::npos)
+            throw std::runtime_error("A presorted join takes a single join column per file.");
     }
     auto get_join_column_names (auto const & args) {
         std::vector<std::string> join_column_names;
@@ -318,6 +823,10 @@ namespace csvjoin::detail {
             if (join_column_names.size() != args.files.size())
                 throw std::runtime_error ("The number of join column names must match the number of files, or be a single "
                                           "column name that exists in all files.");
+            auto const key_size = [](std::string const & key) { return std::count(key.begin(), key.end(), '+'); };
+            if (std::any_of(join_column_names.begin(), join_column_names.end(), [&](auto const & key) {
+                    return key_size(key) != key_size(join_column_names[0]); }))
+                throw std::runtime_error ("The join keys of all the files must have the same number of columns.");
         }
         return join_column_names;
     }
@@ -54,6 +54,7 @@ namespace csvjson {
         bool & no_bbox = flag("no-bbox","Disable the calculation of a bounding box.");
         bool & stream = flag("stream","Output JSON as a stream of newline-separated objects, rather than an as an array.");
         bool & no_inference = flag("I,no-inference", "Disable type inference (and --locale, --date-format, --datetime-format) when parsing the input.");
+        unsigned long & infer_rows = kwarg("infer-rows", "Infer column types from the first N data rows, then test the rest of the rows against the types they left possible only (0: from all the rows). A contradicting value falls back to the next such type, text last.").set_default(0ul);
         bool & date_lib_parser = flag("date-lib-parser", "Use date library as Dates and DateTimes parser backend instead compiler-supported").set_default(true);
 
         void welcome() final {
@@ -26,6 +26,7 @@ namespace csvlook {
         unsigned & max_precision = kwarg("max-precision","The maximum number of decimal places to display. The remainder will be replaced with ellipsis.").set_default(3u);
         bool & no_number_ellipsis = flag("no-number-ellipsis","Disable the ellipsis if --max-precision is exceeded.");
         bool & no_inference = flag("I,no-inference", "Disable type inference (and --locale, --date-format, --datetime-format, --no-leading-zeroes) when parsing the input.");
+        unsigned long & infer_rows = kwarg("infer-rows", "Infer column types from the first N data rows, then test the rest of the rows against the types they left possible only (0: from all the rows). A contradicting value falls back to the next such type, text last.").set_default(0ul);
         std::string & glob_locale = kwarg("G,glob-locale", "Superseded global locale.").set_default("C");
         bool &date_lib_parser = flag("date-lib-parser", "Use date library as Dates and DateTimes parser backend instead compiler-supported").set_default(true);
         bool & asap = flag("ASAP","Print result output stream as soon as possible.").set_default(true);
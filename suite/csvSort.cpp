@@ -7,6 +7,8 @@
 #include <cli-compare.h>
 #include <printer_concepts.h>
 #include "external/poolstl/poolstl.hpp"
+#include <fstream>
+#include <queue>
 
 using namespace ::csvsuite::cli;
 
@@ -24,8 +26,13 @@ namespace csvsort {
         bool & r = flag("r,reverse", "Sort in descending order.");
         bool & ignore_case = flag("i,ignore-case", "Perform case-independent sorting.");
         bool & no_inference = flag("I,no-inference", "Disable type inference (and --locale, --date-format, --datetime-format, --no-leading-zeroes) when parsing the input.");
+        unsigned long & infer_rows = kwarg("infer-rows", "Infer column types from the first N data rows, then test the rest of the rows against the types they left possible only (0: from all the rows). A contradicting value falls back to the next such type, text last.").set_default(0ul);
         bool & date_lib_parser = flag("date-lib-parser", "Use date library as Dates and DateTimes parser backend instead compiler-supported.").set_default(true);
         bool & parallel_sort = flag("p,parallel-sort", "Use parallel sort.").set_default(true);
+        std::string & memory_limit = kwarg("memory-limit", "Keep at most this much of the table in memory, e.g. 512M or 4G, sorting it in runs spilled to temporary files (default: no limit).").set_default(std::string{});
+        unsigned long & head = kwarg("head", "Print only the first N rows of the sorted output (0: all the rows).").set_default(0ul);
+        unsigned long & tail = kwarg("tail", "Print only the last N rows of the sorted output (0: all the rows).").set_default(0ul);
+        std::string & temp_dir = kwarg("temp-dir", "Directory of the temporary files of --memory-limit (default: the system temporary directory).").set_default(std::string{});
         bool & asap = flag("ASAP","Print result output stream as soon as possible.").set_default(true);
 
         void welcome() final {
@@ -48,9 +55,49 @@ namespace csvsort {
             }
         }
 
+        /// Prints the rows of a table in the given order. Chunks of rows are formatted concurrently, each into a buffer
+        /// of its own, and the buffers are written out in order, a wave of chunks at a time.
+        template <class Table>
+        void write(Table & table, std::vector<std::size_t> const & order, auto const & types_blanks, auto const & args) {
+            constexpr std::size_t chunk_rows = 4096;
+            std::vector<std::ostringstream> chunks(std::max(1u, std::thread::hardware_concurrency()));
+            std::vector<std::size_t> chunk_numbers(chunks.size());
+            std::iota(chunk_numbers.begin(), chunk_numbers.end(), 0);
+
+            for (std::size_t wave = 0; wave < order.size(); wave += chunks.size() * chunk_rows) {
+                std::for_each(poolstl::par, chunk_numbers.begin(), chunk_numbers.end(), [&](std::size_t c) {
+                    auto & chunk = chunks[c];
+                    chunk.str({});
+                    printer<std::ostringstream> chunk_printer(chunk);
+                    auto const first = std::min(order.size(), wave + c * chunk_rows);
+                    auto const last = std::min(order.size(), first + chunk_rows);
+                    for (auto i = first; i < last; ++i) {
+                        if (args.linenumbers)
+                            chunk << i + 1 << ',';
+                        chunk_printer.write_cells(table[order[i]], types_blanks, args);
+                        print_LF(chunk);
+                    }
+                });
+                for (auto const & chunk : chunks) {
+                    auto const text = chunk.str();
+                    os.write(text.data(), static_cast<std::streamsize>(text.size()));
+                }
+            }
+        }
+
         // Used by write(Table&& table, auto && types_n_blanks, auto && args) above.
         template<typename Container/*, typename CellString = cell_string*/>
         void write(Container const & row, auto const & types_blanks, auto const & args) requires CsvKitCellSpanRowConcept<Container> {
+            if (args.linenumbers) {
+                static unsigned line_nums = 0;
+                os << ++line_nums << ',';
+            }
+            write_cells(row, types_blanks, args);
+        }
+
+        // Prints the cells of a row only, without a line number
+        template<typename Container>
+        void write_cells(Container const & row, auto const & types_blanks, auto const & args) requires CsvKitCellSpanRowConcept<Container> {
             // typify and compromise_table_MxN filler can work with different cells (quoted and unquoted in same session)
             // So we must "imbue" date and datetime formats when printing almost common cells
             static auto date_format_provider = row.front().date(args.date_fmt);
@@ -87,7 +134,7 @@ namespace csvsort {
                 static std::array<func_type, static_cast<std::size_t>(column_type::sz) - 1> type2func {
                         compose_bool_1_arg<UElemType>
                         , [&args](UElemType const & e) {
-                            static std::ostringstream ss;
+                            thread_local std::ostringstream ss;
                             compose_numeric(ss, e, args);
                             return ss.str();
                         }
@@ -100,11 +147,6 @@ namespace csvsort {
                 print_func_impl(type2func[type_index](unquoted_elem));
             };
 
-            if (args.linenumbers) {
-                static unsigned line_nums = 0;
-                os << ++line_nums << ',';
-            }
-
             unsigned col = 0;
             std::for_each(row.begin(), row.end() - 1, [&](auto & elem) {
                 print_func(elem, col++);
@@ -131,6 +173,203 @@ namespace csvsort {
 
     };
 
+    /// A single key column of numbers, booleans, timedeltas, dates or datetimes is radix sorted
+    inline bool single_radix_key(std::vector<typed_column> const & key_columns) {
+        return key_columns.size() == 1 && key_columns[0].has_radix_key();
+    }
+
+    /// Returns the row count of --head (or --tail, then true), a zero count if all the rows are printed
+    std::tuple<std::size_t, bool> output_rows(auto const & args) {
+        if constexpr (requires { args.head; args.tail; }) {
+            if (args.head && args.tail)
+                throw std::runtime_error("csvsort: error: You may not specify --head and --tail at the same time.");
+            return {args.tail ? args.tail : args.head, args.tail != 0};
+        } else
+            return {0, false};
+    }
+
+    namespace detail {
+        /// A run record is a binary sort key and a formatted row, each preceded by its size
+        inline void write_record(std::ostream & os, std::string_view key, std::string_view row) {
+            for (auto part : {key, row}) {
+                auto const size = static_cast<std::uint32_t>(part.size());
+                os.write(reinterpret_cast<char const *>(&size), sizeof(size));
+                os.write(part.data(), static_cast<std::streamsize>(part.size()));
+            }
+        }
+
+        /// Reads the next record of a run, false at the end of it. A record cut short is an error.
+        inline bool read_record(std::istream & is, std::filesystem::path const & path, std::string & key, std::string & row) {
+            for (auto part : {&key, &row}) {
+                std::uint32_t size;
+                if (!is.read(reinterpret_cast<char *>(&size), sizeof(size))) {
+                    if (part == &key && !is.gcount() && is.eof())
+                        return false;
+                    throw std::runtime_error("Can not read the temporary file " + path.string());
+                }
+                part->resize(size);
+                if (!is.read(part->data(), size))
+                    throw std::runtime_error("Can not read the temporary file " + path.string());
+            }
+            return true;
+        }
+
+        /// Bytes a row takes while its run is in memory: its cell spans (and as much again for the sorting), and for
+        /// every key column its parsed value, its binary key with the offset of it, and with --ignore-case the case-folded
+        /// copy of its text. A text key is as long as its cell, the other keys are of a few bytes.
+        template <class Row>
+        std::size_t run_row_bytes(Row const & row, std::vector<unsigned> const & ids, auto const & args) {
+            using elem_type = std::decay_t<decltype(row[0])>;
+            using UElemType = typename elem_type::template rebind<csv_co::unquoted>::other;
+            constexpr std::size_t key_value_bytes = sizeof(long double) + sizeof(std::string_view) + 32;
+            bool ignore_case = false;
+            if constexpr (requires { args.ignore_case; })
+                ignore_case = args.ignore_case;
+            std::size_t bytes = 2 * row.size() * sizeof(elem_type) + 2 * sizeof(std::size_t);
+            for (auto id : ids) {
+                auto const text_bytes = row[id].operator UElemType const&().raw_string_view().size();
+                bytes += key_value_bytes + text_bytes + (ignore_case ? sizeof(std::string) + text_bytes : 0);
+            }
+            return bytes;
+        }
+
+        /// Most runs merged at a time, so that the open files stay well within the limits of a process
+        constexpr std::size_t merge_fan_in = 128;
+
+        /// Merges runs by their keys and calls f(key, row) for every record, as long as it returns true.
+        /// Equal keys are taken from the earlier run to keep the input order.
+        inline void merge_runs(std::vector<std::filesystem::path> const & paths, auto && f) {
+            struct cursor {
+                std::ifstream in;
+                std::string key;
+                std::string row;
+            };
+            std::vector<cursor> cursors(paths.size());
+            auto const later = [&](std::size_t a, std::size_t b) {
+                auto const result = cursors[a].key.compare(cursors[b].key);
+                return result ? result > 0 : a > b;
+            };
+            std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(later)> heap(later);
+            auto next = [&](std::size_t i) {
+                if (read_record(cursors[i].in, paths[i], cursors[i].key, cursors[i].row))
+                    heap.push(i);
+            };
+            for (std::size_t i = 0; i < cursors.size(); ++i) {
+                cursors[i].in.open(paths[i], std::ios::binary);
+                if (!cursors[i].in)
+                    throw std::runtime_error("Can not open the temporary file " + paths[i].string());
+                next(i);
+            }
+            while (!heap.empty()) {
+                auto const i = heap.top();
+                heap.pop();
+                if (!f(cursors[i].key, cursors[i].row))
+                    return;
+                next(i);
+            }
+        }
+    }
+
+    /// Sorts the body in runs of a bounded size: a run is sorted (in parallel) by its binary keys, formatted and spilled
+    /// to a temporary file, and the runs are then merged by their keys into the output.
+    /// The order and the formatting are those of the in-memory sort, and so are --head and --tail.
+    template <typename Reader, typename Args>
+    void sort_in_runs(Reader & reader, Args const & args, std::vector<unsigned> const & ids, auto const & types_blanks, std::size_t limit, std::ostream & os) {
+        using elem_type = typename Reader::template typed_span<csv_co::quoted>;
+        auto const & types = std::get<0>(types_blanks);
+        auto const & blanks = std::get<1>(types_blanks);
+
+        reader.skip_rows(0);
+        skip_lines(reader, args);
+        auto const columns = obtain_header_and_<skip_header>(reader, args).size();
+
+        temp_files files(temp_dir(args), "csvsort-", ".run");
+        cell_arena_MxN<elem_type> run(columns);
+        std::ostringstream row_stream;
+        printer row_printer(row_stream);
+        std::size_t total_rows = 0;
+        std::size_t run_bytes = 0;
+
+        auto spill = [&] {
+            std::vector<typed_column> key_columns;
+            key_columns.reserve(ids.size());
+            for (auto id : ids)
+                key_columns.emplace_back(run, id, types[id], blanks[id], args);
+            sort_keys const keys(key_columns, run.rows(), args.r);
+
+            auto const & path = files.create();
+            std::ofstream out(path, std::ios::binary);
+            for (auto r : single_radix_key(key_columns) ? radix_sorted_rows(key_columns[0], run.rows(), args.r, args.parallel_sort)
+                                                        : sorted_rows(keys, args.parallel_sort)) {
+                row_stream.str({});
+                row_printer.write_cells(run[r], types_blanks, args);
+                detail::write_record(out, keys[r], row_stream.str());
+            }
+            if (!out.flush())
+                throw std::runtime_error("Can not write the temporary file " + path.string());
+            total_rows += run.rows();
+            run.clear();
+            run_bytes = 0;
+        };
+
+        // a run is cut as soon as its rows and their keys reach the limit
+        reader.run_rows([&](auto & row_span) {
+            run.append(row_span);
+            run_bytes += detail::run_row_bytes(run[run.rows() - 1], ids, args);
+            if (run_bytes >= limit)
+                spill();
+        });
+        if (run.rows())
+            spill();
+
+        // Runs are merged merge_fan_in at a time into longer runs, which keeps their order, until one merge is left
+        std::vector<std::filesystem::path> runs(files.paths().begin(), files.paths().end());
+        while (runs.size() > detail::merge_fan_in) {
+            std::vector<std::filesystem::path> merged_runs;
+            for (std::size_t first = 0; first < runs.size(); first += detail::merge_fan_in) {
+                std::vector<std::filesystem::path> const group(runs.begin() + static_cast<std::ptrdiff_t>(first)
+                                                             , runs.begin() + static_cast<std::ptrdiff_t>(std::min(runs.size(), first + detail::merge_fan_in)));
+                if (group.size() == 1) {
+                    merged_runs.push_back(group.front());
+                    continue;
+                }
+                auto const & path = files.create();
+                std::ofstream out(path, std::ios::binary);
+                detail::merge_runs(group, [&](std::string const & key, std::string const & row) {
+                    detail::write_record(out, key, row);
+                    return true;
+                });
+                if (!out.flush())
+                    throw std::runtime_error("Can not write the temporary file " + path.string());
+                for (auto const & e : group) {
+                    std::error_code ec;
+                    std::filesystem::remove(e, ec);
+                }
+                merged_runs.push_back(path);
+            }
+            runs = std::move(merged_runs);
+        }
+
+        // the merged rows in [first_row, last_row) are printed
+        auto const [count, from_end] = output_rows(args);
+        auto const first_row = count && from_end ? total_rows - std::min(total_rows, count) : 0;
+        auto const last_row = count && !from_end ? std::min(total_rows, count) : total_rows;
+
+        unsigned line_number = 0;
+        std::size_t merged = 0;
+        detail::merge_runs(runs, [&](std::string const &, std::string const & row) {
+            if (merged == last_row)
+                return false;
+            if (merged++ >= first_row) {
+                if (args.linenumbers)
+                    os << ++line_number << ',';
+                os << row;
+                print_LF(os);
+            }
+            return true;
+        });
+    }
+
     template <typename Reader, typename Args>
     void setup_string_comparison_type(Reader &, Args const &args) {
         using unquoted_elem_type = typename Reader::template typed_span<csv_co::unquoted>;
@@ -156,43 +395,14 @@ namespace csvsort {
 
             setup_string_comparison_type(reader, args);
 
-            auto const types_blanks = std::get<1>(typify(reader, args, typify_option::typify_without_precisions));
+            // Within a memory limit the types are inferred batch by batch as well
+            using unquoted_elem_type = typename std::decay_t<decltype(reader)>::template typed_span<csv_co::unquoted>;
+            auto const limit = memory_limit(args);
+            auto const [count, from_end] = output_rows(args);
+            auto const typify_batch = limit ? std::max<std::size_t>(1, limit / (header.size() * sizeof(unquoted_elem_type))) : 0;
+            auto const types_blanks = std::get<1>(typify(reader, args, typify_option::typify_without_precisions, typify_batch));
 
             using namespace ::csvsuite::cli::compare;
-            // Filling in data to sort.
-            // It is sufficient to have csv_co::quoted cell_spans in it, because comparison is quite sophisticated and takes it into account
-            compromise_table_MxN table(reader, args);
-
-            auto cfa = obtain_compare_functionality<std::decay_t<decltype(table[0][0])>>(ids, types_blanks, args);
-            if (args.r) {
-                if (args.parallel_sort)
-                    std::sort(poolstl::par, table.begin(), table.end(), sort_comparator(std::move(cfa), std::greater<>()));
-                else
-                    std::sort(table.begin(), table.end(), sort_comparator(std::move(cfa), std::greater<>()));
-            }
-            else {
-                if (args.parallel_sort)
-                    std::sort(poolstl::par, table.begin(), table.end(), sort_comparator(std::move(cfa), std::less<>()));
-                else
-                    std::sort(table.begin(), table.end(), sort_comparator(std::move(cfa), std::less<>()));
-            }
-            // Force detecting types for all rest (not-comparable) cells concurrently to reduce result output time
-            for_each(poolstl::par, table.begin(), table.end(), [&](
-#ifdef _MSC_VER
-                    std::decay_t<decltype(table[0])> & item
-#else
-                    auto & item
-#endif
-                    ) {
-                for (auto & elem : item) {
-                    using UElemType = typename std::decay_t<decltype(elem)>::template rebind<csv_co::unquoted>::other;
-                    elem.operator UElemType const&().type();
-                }
-            });
-
-            std::ostringstream oss;
-            std::ostream & oss_ = args.asap ? std::cout : oss;
-            printer p(oss_);
 
             std::vector<std::string> string_header(header.size());
             std::transform(header.cbegin(), header.cend(), string_header.begin(), [&](
@@ -205,8 +415,36 @@ namespace csvsort {
                 return compose_text(elem);
             });
 
+            if (limit) {
+                printer(std::cout).write(string_header, args);
+                sort_in_runs(reader, args, ids, types_blanks, limit, std::cout);
+                return;
+            }
+
+            // Filling in data to sort, row after row in a single buffer.
+            // It is sufficient to have csv_co::quoted cell_spans in it, because comparison is quite sophisticated and takes it into account
+            cell_arena_MxN table(reader, args);
+
+            // Key values are parsed once into columns and encoded into binary keys, then the rows are sorted by
+            // plain byte comparison of the keys, or radix sorted by a single numeric or date key.
+            // Equal keys keep the input order of the rows. The rows stay in place, the output follows the order.
+            // With --head or --tail only the rows to print are selected and sorted.
+            auto const & [types, blanks] = types_blanks;
+            std::vector<typed_column> key_columns;
+            key_columns.reserve(ids.size());
+            for (auto id : ids)
+                key_columns.emplace_back(table, id, types[id], blanks[id], args);
+
+            auto const order = count ? top_rows(sort_keys(key_columns, table.rows(), args.r), count, from_end, args.parallel_sort)
+                             : single_radix_key(key_columns) ? radix_sorted_rows(key_columns[0], table.rows(), args.r, args.parallel_sort)
+                             : sorted_rows(sort_keys(key_columns, table.rows(), args.r), args.parallel_sort);
+
+            std::ostringstream oss;
+            std::ostream & oss_ = args.asap ? std::cout : oss;
+            printer p(oss_);
+
             p.write(string_header, args);
-            p.write(table, types_blanks, args);
+            p.write(table, order, types_blanks, args);
 
             if (!args.asap)
                 std::cout << oss.str();
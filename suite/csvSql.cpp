@@ -46,6 +46,7 @@ namespace csvsql::detail {
         std::string & db_schema = kwarg("db-schema","Optional name of database schema to create table(s) in.").set_default(std::string(""));
 #endif
         bool &no_inference = flag("I,no-inference", "Disable type inference (and --locale, --date-format, --datetime-format, --no-leading-zeroes) when parsing the input.");
+        unsigned long &infer_rows = kwarg("infer-rows", "Infer column types from the first N data rows, then test the rest of the rows against the types they left possible only (0: from all the rows). A contradicting value falls back to the next such type, text last.").set_default(0ul);
         unsigned & chunk_size = kwarg("chunk-size","Chunk size for batch insert into the table. Requires --insert.").set_default(0);
         bool &date_lib_parser = flag("date-lib-parser", "Use date library as Dates and DateTimes parser backend instead compiler-supported").set_default(true);
 
@@ -10,6 +10,8 @@
 #include <numeric>
 #include <cmath>
 #include <cli.h>
+#include <cli-sketch.h>
+#include "external/poolstl/poolstl.hpp"
 
 using namespace ::csvsuite::cli;
 using namespace csv_co;
@@ -49,14 +51,91 @@ namespace csvstat {
         std::string &decimal_format = kwarg("decimal-format","%-format specification for printing decimal numbers. Defaults to locale-specific formatting with \"%.3f\"").set_default("%.3f");
         bool &no_grouping_sep = flag("G,no-grouping-separator", "Do not use grouping separators in decimal numbers");
         bool &no_inference = flag("I,no-inference","Disable type inference (and --locale, --date-format, --datetime-format, --no-leading-zeroes) when parsing the input.");
+        unsigned long &infer_rows = kwarg("infer-rows", "Infer column types from the first N data rows, then test the rest of the rows against the types they left possible only (0: from all the rows). A contradicting value falls back to the next such type, text last.").set_default(0ul);
         bool &no_mdp = flag("no-mdp,no-max-precision","Do not calculate most decimal places.");
         bool &date_lib_parser = flag("date-lib-parser", "Use date library as Dates and DateTimes parser backend instead compiler-supported").set_default(true);
+        bool &streaming = flag("streaming", "Make a single pass over the file keeping a batch of rows in memory at a time. Large numbers of unique values, medians and most common values are then estimated, and marked as approximate.");
 
         void welcome() final {
             std::cout << "\nPrint descriptive statistics for each column in a CSV file.\n\n";
         }
     };
 
+    /// Memory a batch of rows may take with --streaming
+    constexpr std::size_t streaming_batch_bytes = std::size_t{64} << 20;
+
+    /// Counters of most common values kept with --streaming: enough for the printed frequencies to be exact as a rule
+    auto frequent_capacity(auto const & args) -> std::size_t {
+        return std::max<std::size_t>(4096, 64 * args.freq_count);
+    }
+
+    /// Hashes dates and datetimes for the --streaming sketches
+    struct sys_seconds_hash {
+        std::size_t operator()(date::sys_seconds const & value) const noexcept {
+            return std::hash<long long>{}(value.time_since_epoch().count());
+        }
+    };
+
+    /// Least rows in a chunk of a column aggregated concurrently with the other chunks
+    constexpr std::size_t column_chunk_rows = 65536;
+
+    /// Splits the rows of a column into chunks, degree of them at most, aggregates them concurrently and returns the
+    /// partial aggregates in the row order, to be merged in that order
+    template <class Partial>
+    std::vector<Partial> aggregate_chunks(std::size_t rows, unsigned degree, auto && aggregate) {
+        auto const chunks = std::clamp<std::size_t>(rows / column_chunk_rows, 1, degree);
+        std::vector<Partial> partials(chunks);
+        std::vector<std::size_t> chunk_numbers(chunks);
+        std::iota(chunk_numbers.begin(), chunk_numbers.end(), 0);
+        auto run = [&](std::size_t c) { aggregate(c * rows / chunks, (c + 1) * rows / chunks, partials[c]); };
+        if (chunks == 1)
+            run(0);
+        else
+            std::for_each(poolstl::par, chunk_numbers.begin(), chunk_numbers.end(), run);
+        return partials;
+    }
+
+    /// Value counts of a chunk of a column, kept in the order the values first appear. Merging the chunks in the row
+    /// order inserts the values into a frequency map in the very order a serial pass does, so even an unordered map
+    /// ends up iterating (and its ties being reported) the same way.
+    template <class Map>
+    class partial_counts {
+        Map slots_;
+        std::vector<std::pair<typename Map::key_type, std::size_t>> counts_;
+    public:
+        void add(typename Map::key_type const & value) {
+            auto const [it, inserted] = slots_.try_emplace(value, counts_.size());
+            if (inserted)
+                counts_.emplace_back(value, 0);
+            ++counts_[it->second].second;
+        }
+        void merge_into(Map & map) const {
+            for (auto const & [value, count] : counts_)
+                map[value] += count;
+        }
+    };
+
+    /// A buffer of the non-null values of a column to select the median from. Every column thread has one, so its
+    /// memory is reused by the columns that thread aggregates.
+    inline std::vector<long double> & median_buffer() {
+        thread_local std::vector<long double> buffer;
+        buffer.clear();
+        return buffer;
+    }
+
+    /// The median of numbers, by selection rather than by sorting them; reorders the values. NaNs are taken as greater
+    /// than any number, as the sorting did, but they are put aside before the selection, which needs a strict order.
+    inline long double median_of(std::vector<long double> & values) {
+        auto const numbers = std::partition(values.begin(), values.end(), [](auto v) { return !std::isnan(v); });
+        auto const mm = values.begin() + static_cast<std::ptrdiff_t>(values.size() / 2);
+        if (mm >= numbers)
+            return NAN;
+        std::nth_element(values.begin(), mm, numbers);
+        if (values.size() & 1)
+            return *mm;
+        return (*mm + *std::max_element(values.begin(), mm)) / 2;
+    }
+
     template<class B>
     struct number_class;
 
@@ -100,13 +179,17 @@ namespace csvstat {
         std::size_t non_null_values_{0};
         std::size_t unique_values_{0};
         std::size_t numeric_NaNs {0};
+        bool approximate_unique_ {false};
+        bool approximate_freq_ {false};
         void set_numeric_NaNs(std::size_t nans) { numeric_NaNs = nans; }
         friend struct number_class<base<TabularType, ArgsType>>;
     protected:
         [[nodiscard]] std::reference_wrapper<TabularType> const & dim_2() const { return _2d_; };
+        [[nodiscard]] unsigned column_concurrency() const;
         template <typename OutputType = std::string>
         inline void compose_operation_result(std::size_t lines, OutputType const &) const;
         inline void complete(std::size_t null_number, auto & mcv_map, auto & mcv_vec);
+        inline void complete_streaming(std::size_t null_number, auto const & distinct, auto const & frequent, auto & mcv_vec);
     public:
         void single_operation(auto output_lines);
         void operation_result() const;
@@ -122,6 +205,8 @@ namespace csvstat {
         [[nodiscard]] inline std::size_t & non_nulls() { return non_null_values_; }
         [[nodiscard]] std::size_t non_nulls() const { return non_null_values_; }
         [[nodiscard]] std::size_t uniques() const { return unique_values_; }
+        [[nodiscard]] bool approximate_unique() const { return approximate_unique_; }
+        [[nodiscard]] bool approximate_freq() const { return approximate_freq_; }
         [[nodiscard]] std::reference_wrapper<ArgsType const> const & args() const { return args_; }
     };
 
@@ -131,8 +216,12 @@ namespace csvstat {
         template <class ... T>
         explicit number_class(T &&... args);
         void prepare();
+        void accumulate(std::size_t rows);
+        void finish();
         struct result;
         std::shared_ptr<result> r;
+        struct streaming;
+        std::shared_ptr<streaming> s;
     private:
         void type(std::size_t output_lines) override;
         void unique(std::size_t output_lines) override;
@@ -157,8 +246,12 @@ namespace csvstat {
         template <class ... T>
         explicit timedelta_class(T &&... args);
         void prepare();
+        void accumulate(std::size_t rows);
+        void finish();
         struct result;
         std::shared_ptr<result> r;
+        struct streaming;
+        std::shared_ptr<streaming> s;
     private:
         void type(std::size_t output_lines) override;
         void unique(std::size_t output_lines) override;
@@ -178,6 +271,10 @@ namespace csvstat {
     struct bool_class final : B {
         using B::B;
         void prepare();
+        void accumulate(std::size_t rows);
+        void finish();
+        struct streaming;
+        std::shared_ptr<streaming> s;
     private:
         void type(std::size_t output_lines) override;
         void unique(std::size_t output_lines) override;
@@ -195,8 +292,12 @@ namespace csvstat {
         template <class ... T>
         explicit text_class(T &&... args);
         void prepare();
+        void accumulate(std::size_t rows);
+        void finish();
         struct result;
         std::shared_ptr<result> r;
+        struct streaming;
+        std::shared_ptr<streaming> s;
     private:
         void type(std::size_t output_lines) override;
         void unique(std::size_t output_lines) override;
@@ -215,8 +316,12 @@ namespace csvstat {
         template <class ... T>
         explicit date_class(T &&... args);
         void prepare();
+        void accumulate(std::size_t rows);
+        void finish();
         struct result;
         std::shared_ptr<result> r;
+        struct streaming;
+        std::shared_ptr<streaming> s;
     private:
         void type(std::size_t output_lines) override;
         void unique(std::size_t output_lines) override;
@@ -236,8 +341,12 @@ namespace csvstat {
         template <class ... T>
         explicit datetime_class(T &&... args);
         void prepare();
+        void accumulate(std::size_t rows);
+        void finish();
         struct result;
         std::shared_ptr<result> r;
+        struct streaming;
+        std::shared_ptr<streaming> s;
     private:
         void type(std::size_t output_lines) override;
         void unique(std::size_t output_lines) override;
@@ -317,6 +426,8 @@ namespace csvstat {
 
     struct no_calculation_class final  {
         void prepare() {}
+        void accumulate(std::size_t) {}
+        void finish() {}
         void single_operation(std::size_t) {}
         [[nodiscard]] static std::size_t row_count() { return 0; }
         void operation_result() {}
@@ -362,139 +473,55 @@ namespace csvstat {
             using cell_span_t = typename std::decay_t<decltype(reader)>::template typed_span<csv_co::unquoted>;
             using tabular_type = fixed_array_2d_replacement<cell_span_t>;
 
-            // Filling in 2d in the transposed form, process each column a bit cache-friendly
-            tabular_type transposed_2d(cols, body_rows);
-
-            auto c_row{0u};
-            auto c_col{0u};
-
-            max_field_size_checker size_checker(reader, args, header.size(), init_row{args.no_header ? 1u : 2u});
-
-            auto all_columns_selected = [&] {
-                if (header.size() != ids.size())
-                    return false;
-                std::vector<unsigned> atom (ids.size());
-                std::iota(atom.begin(), atom.end(), 0);
-                return (ids == atom);
-            };
+            // With --streaming the table holds a batch of rows at a time, not the whole body, and the columns are
+            // typified beforehand, batch by batch as well
+            bool const streaming = args.streaming && !args.count && body_rows;
+            auto const batch_rows = std::max<std::size_t>(1, streaming_batch_bytes / (std::max<std::size_t>(1, header.size()) * sizeof(cell_span_t)));
 
-            if (all_columns_selected())
-                reader.run_rows([&](auto &row_span) { // more cache-friendly
-                    check_max_size(row_span, size_checker);
-                    for (auto &elem: row_span)
-                        transposed_2d[c_col++][c_row] = elem;
-                    c_row++;
-                    c_col = 0;
-                });
-            else
-                reader.run_rows([&](auto &row_span) { // less cache-friendly
-                    check_max_size(row_span, size_checker);
-                    for (auto i: ids)
-                        transposed_2d[c_col++][c_row] = row_span[i];
-                    c_row++;
-                    c_col = 0;
-                });
-
-            if (args.count) {
-                std::cout << std::to_string(body_rows) + '\n';
-                return;
-            }
-
-            auto prepare_task_vector = [&](auto &reader, auto const &args, auto &transposed_2d, auto const &header, auto const &ids) {
-                using Reader = std::decay_t<decltype(reader)>;
-                using table_type = fixed_array_2d_replacement<typename Reader::template typed_span<csv_co::unquoted>>;
-                auto detect_types_and_blanks = [&] (table_type & table) {
-
-                    update_null_values(args.null_value);
+            // Filling in 2d in the transposed form, process each column a bit cache-friendly
+            auto const table_rows = streaming ? std::min<std::size_t>(body_rows, batch_rows) : body_rows;
+            tabular_type transposed_2d(cols, table_rows);
 
-                    std::vector<column_type> types (table.rows(), column_type::unknown_t);
+            auto detect_types_and_blanks = [&] (tabular_type & table) {
 
-                    std::vector<std::size_t> column_numbers (types.size());
-                    std::iota(column_numbers.begin(), column_numbers.end(), 0);
+                update_null_values(args.null_value);
 
-                    transwarp::parallel exec(std::thread::hardware_concurrency());
-                    std::vector<unsigned char> blanks (types.size(), 0);
+                std::vector<column_type> types (table.rows(), column_type::unknown_t);
+                std::vector<unsigned char> blanks (types.size(), 0);
 
-                    imbue_numeric_locale(reader, args);
+                imbue_numeric_locale(reader, args);
 
-                    [&args] {
-                        using reader_type = std::decay_t<decltype(reader)>;
+                [&args] {
+                    using reader_type = std::decay_t<decltype(reader)>;
 
-                        using unquoted_elem_type = typename reader_type::template typed_span<csv_co::unquoted>;
-                        unquoted_elem_type::no_maxprecision(args.no_mdp);
+                    using unquoted_elem_type = typename reader_type::template typed_span<csv_co::unquoted>;
+                    unquoted_elem_type::no_maxprecision(args.no_mdp);
 
-                        using quoted_elem_type = typename reader_type::template typed_span<csv_co::quoted>;
-                        quoted_elem_type::no_maxprecision(args.no_mdp);
-                    }();
+                    using quoted_elem_type = typename reader_type::template typed_span<csv_co::quoted>;
+                    quoted_elem_type::no_maxprecision(args.no_mdp);
+                }();
 
-                    setup_date_parser_backend(reader, args);
-                    setup_leading_zeroes_processing(reader, args);
+                setup_date_parser_backend(reader, args);
+                setup_leading_zeroes_processing(reader, args);
 
-                    //TODO: for now e.is_null() calling first is obligate. Can we do better?
-                    #define SETUP_NULLS_AND_BLANKS auto const n = e.is_null_or_null_value() && !args.blanks; if (!blanks[c] && n) blanks[c] = true;
+                auto const lattices = infer_table(table, args, false, true);
+                for (auto c = 0u; c < types.size(); ++c) {
+                    types[c] = lattices[c].type();
+                    blanks[c] = lattices[c].blanks;
+                }
 
-                    auto task = transwarp::for_each(exec, column_numbers.cbegin(), column_numbers.cend(), [&](auto c) {
-                        if (std::all_of(table[c].cbegin(), table[c].cend(), [&blanks, &c, &args](auto & e) {
-                            SETUP_NULLS_AND_BLANKS
-                            return n || (!args.no_inference && e.is_boolean());
-                        })) {
-                            types[c] = column_type::bool_t;
-                            return;
-                        }
-                        if (std::all_of(table[c].cbegin(), table[c].cend(), [&args, &blanks, &c](auto &e) {
-                            SETUP_NULLS_AND_BLANKS
-                            return n || (!args.no_inference && std::get<0>(e.timedelta_tuple()));
-                        })) {
-                            types[c] = column_type::timedelta_t;
-                            return;
-                        }
-                        if (std::all_of(table[c].cbegin(), table[c].cend(), [&args, &blanks, &c](auto & e) {
-                            SETUP_NULLS_AND_BLANKS
-                            return n || (!args.no_inference && std::get<0>(e.datetime(args.datetime_fmt)));
-                        })) {
-                            types[c] = column_type::datetime_t;
-                            return;
-                        }
-                        if (std::all_of(table[c].cbegin(), table[c].cend(), [&args, &blanks, &c](auto &e) {
-                            SETUP_NULLS_AND_BLANKS
-                            return n || (!args.no_inference && std::get<0>(e.date(args.date_fmt)));
-                        })) {
-                            types[c] = column_type::date_t;
-                            return;
-                        }
-                        if (std::all_of(table[c].cbegin(), table[c].cend(), [&blanks, &c, &args](auto & e) {
-                            SETUP_NULLS_AND_BLANKS
-                            return n || (!args.no_inference && e.is_num());
-                        })) {
-                            types[c] = column_type::number_t;
-                            return;
-                        }
-                        // Text type: check ALL rows for an absent.
-                        if (std::all_of(table[c].cbegin(), table[c].cend(), [&](auto &e) {
-                            if (e.is_null_or_null_value() && !blanks[c] && !args.blanks)
-                                blanks[c] = true;
-                            return true;
-                        })) {
-                            types[c] = column_type::text_t;
-                            return;
-                        }
-                    });
-                    task->wait();
-                    #undef SETUP_NULLS_AND_BLANKS
-
-                    for (auto & elem : types) {
-                        assert(elem != column_type::unknown_t);
-                        if (args.no_inference and elem != column_type::text_t) {
-                            assert(elem == column_type::bool_t);  // all nulls in a column otherwise boolean
-                            elem = column_type::text_t;           // force setting it to text
-                        }
+                for (auto & elem : types) {
+                    assert(elem != column_type::unknown_t);
+                    if (args.no_inference and elem != column_type::text_t) {
+                        assert(elem == column_type::bool_t);  // all nulls in a column otherwise boolean
+                        elem = column_type::text_t;           // force setting it to text
                     }
+                }
 
-                    return std::tuple{types, blanks};
-                };
-
-                auto [types, blanks] = detect_types_and_blanks(transposed_2d);
+                return std::tuple{types, blanks};
+            };
 
+            auto prepare_task_vector = [&](auto const &args, auto &transposed_2d, auto const &header, auto const &ids, auto const &types, auto const &blanks) {
                 using tabular_t = std::decay_t<decltype(transposed_2d)>;
                 using args_type = std::decay_t<decltype(args)>;
 
@@ -542,14 +569,82 @@ namespace csvstat {
                 return task_vec;
             };
 
-            auto tv = prepare_task_vector(reader, args, transposed_2d, header, ids);
+            decltype(prepare_task_vector(args, transposed_2d, header, ids, std::vector<column_type>{}, std::vector<unsigned char>{})) tv;
             transwarp::parallel exec(std::thread::hardware_concurrency());
-            auto task = transwarp::for_each(exec, tv.begin(), tv.end(), [&](auto &item) {
-                std::visit([&](auto &&arg) {
+            auto for_each_task = [&](auto && f) {
+                auto task = transwarp::for_each(exec, tv.begin(), tv.end(), [&](auto &item) {
+                    std::visit(f, item);
+                });
+                task->wait();
+            };
+
+            if (streaming) {
+                auto const types_blanks = std::get<1>(typify(reader, args, typify_option::typify_without_precisions, batch_rows));
+                std::vector<column_type> types;
+                std::vector<unsigned char> blanks;
+                for (auto i : ids) {
+                    types.push_back(std::get<0>(types_blanks)[i]);
+                    blanks.push_back(std::get<1>(types_blanks)[i]);
+                }
+                cell_span_t::no_maxprecision(args.no_mdp);
+                skip_lines(reader, args);
+                obtain_header_and_<skip_header>(reader, args);
+                tv = prepare_task_vector(args, transposed_2d, header, ids, types, blanks);
+            }
+
+            auto c_row{0u};
+            auto c_col{0u};
+
+            // A full batch is accumulated, and the table is filled again
+            auto next_row = [&] {
+                c_col = 0;
+                if (++c_row == table_rows && streaming) {
+                    for_each_task([&](auto &&arg) { arg.accumulate(c_row); });
+                    c_row = 0;
+                }
+            };
+
+            max_field_size_checker size_checker(reader, args, header.size(), init_row{args.no_header ? 1u : 2u});
+
+            auto all_columns_selected = [&] {
+                if (header.size() != ids.size())
+                    return false;
+                std::vector<unsigned> atom (ids.size());
+                std::iota(atom.begin(), atom.end(), 0);
+                return (ids == atom);
+            };
+
+            if (all_columns_selected())
+                reader.run_rows([&](auto &row_span) { // more cache-friendly
+                    check_max_size(row_span, size_checker);
+                    for (auto &elem: row_span)
+                        transposed_2d[c_col++][c_row] = elem;
+                    next_row();
+                });
+            else
+                reader.run_rows([&](auto &row_span) { // less cache-friendly
+                    check_max_size(row_span, size_checker);
+                    for (auto i: ids)
+                        transposed_2d[c_col++][c_row] = row_span[i];
+                    next_row();
+                });
+
+            if (args.count) {
+                std::cout << std::to_string(body_rows) + '\n';
+                return;
+            }
+
+            if (streaming) {
+                if (c_row)
+                    for_each_task([&](auto &&arg) { arg.accumulate(c_row); });
+                for_each_task([&](auto &&arg) { arg.finish(); });
+            } else {
+                auto [types, blanks] = detect_types_and_blanks(transposed_2d);
+                tv = prepare_task_vector(args, transposed_2d, header, ids, types, blanks);
+                for_each_task([&](auto &&arg) {
                     operation_option ? arg.single_operation(cols) : arg.prepare();
-                }, item);
-            });
-            task->wait();
+                });
+            }
 
             if (operation_option) {
                 for (auto &item: tv)
@@ -570,7 +665,7 @@ namespace csvstat {
                 }
             }
             if (!args.csv && !args.json)
-                std::visit([](auto &&arg) { std::cout << "Row count: " << std::to_string(arg.row_count()) << '\n'; }, tv[0]);
+                std::visit([&](auto &&arg) { std::cout << "Row count: " << std::to_string(streaming ? body_rows : arg.row_count()) << '\n'; }, tv[0]);
         } catch (ColumnIdentifierError const &e) {
             std::cout << e.what() << '\n';
         }
@@ -659,6 +754,8 @@ namespace csvstat {
             throw std::runtime_error("csvstat: error: You may not specify --json and an operation (--mean, --median, etc) at the same time.");
         if (operations > 1)
             throw std::runtime_error("csvstat: error: Only one operation argument may be specified (--mean, --median, etc).");
+        if (operations and args.streaming and !args.count)
+            throw std::runtime_error("csvstat: error: You may not specify --streaming and an operation (--mean, --median, etc) at the same time.");
         return operations;
     }
 
@@ -673,6 +770,13 @@ namespace csvstat {
         return _2d_.get().cols();
     }
 
+    template<class TabularType, class ArgsType>
+    unsigned base<TabularType, ArgsType>::column_concurrency() const {
+        // columns are aggregated concurrently already, so a column gets its share of the hardware threads
+        auto const columns = std::max<std::size_t>(1, _2d_.get().rows());
+        return std::max<unsigned>(1, static_cast<unsigned>(std::thread::hardware_concurrency() / columns));
+    }
+
     template<class TabularType, class ArgsType>
     void base<TabularType, ArgsType>::print_column_header(std::ostream & os) const {
         os << std::setw(3) << phys_index_ + 1 << ". " << static_cast<const decltype(column_name())>(column_name()) << ": ";
@@ -753,7 +857,7 @@ namespace csvstat {
 
     template<class TabularType, class ArgsType>
     auto base<TabularType, ArgsType>::prepare_mcv_vec(auto & mcv_map) {
-        using map_value_type = std::pair<typename std::decay_t<decltype(mcv_map)>::key_type, std::size_t>;
+        using map_value_type = std::pair<std::decay_t<decltype(mcv_map.begin()->first)>, std::size_t>;
         std::vector<map_value_type> v(mcv_map.begin(), mcv_map.end());
 
         auto const mcv_printed = args_.get().freq_count;
@@ -792,6 +896,16 @@ namespace csvstat {
         mcv_vec = prepare_mcv_vec(mcv_map);
     }
 
+    template<class TabularType, class ArgsType>
+    inline void base<TabularType, ArgsType>::complete_streaming(std::size_t null_number, auto const & distinct, auto const & frequent, auto & mcv_vec) {
+        null_values_ = null_number;
+        unique_values_ = distinct.count() + numeric_NaNs + (null_number ? 1 : 0);
+        approximate_unique_ = !distinct.exact();
+        approximate_freq_ = !frequent.exact();
+        auto const counts = frequent.counts();
+        mcv_vec = prepare_mcv_vec(counts);
+    }
+
     template<class TabularType, class ArgsType>
     void base<TabularType, ArgsType>::single_operation(auto output_lines) {
         if (args_.get().type)
@@ -837,6 +951,7 @@ namespace csvstat {
         long double stdev;
         bool stdev_none;
         unsigned    mdp;
+        bool approximate_median {false};
     };
 
     template<class B>
@@ -871,61 +986,62 @@ namespace csvstat {
         unsigned char mdp = 0;
         std::size_t NaNs = 0;
 
-        using elem_t = decltype(slice[0]);
-        std::function<unsigned char(elem_t&)> mdp_calc;
-        if (this->args().get().no_mdp)
-            mdp_calc = [&](elem_t&) { return 0; };
-        else
-            mdp_calc = [&](elem_t& elem) { return std::max(elem.precision(), mdp); };
-
-        for (auto & elem : slice) {
-            assert(elem.is_num() || elem.is_null_or_null_value());
-            if (!elem.is_null_or_null_value()) {
-                auto const element_value = elem.num();
+        // Chunks of the column are parsed concurrently. The sums and the rolling mean and variance are accumulated
+        // from the parsed values in the row order, since merging the partial ones would not give the same figures.
+        // A chunk parses its values into its own rows of the median buffer, which are then packed in place.
+        struct partial {
+            std::size_t first = 0;
+            std::size_t values = 0;
+            partial_counts<decltype(mcv_map_)> counts;
+            std::size_t nulls = 0;
+            std::size_t NaNs = 0;
+            unsigned char mdp = 0;
+        };
+        auto & values = median_buffer();
+        values.resize(slice.size());
+        bool const no_mdp = this->args().get().no_mdp;
+        auto const partials = aggregate_chunks<partial>(slice.size(), B::column_concurrency(), [&](std::size_t first, std::size_t last, partial & p) {
+            p.first = first;
+            for (auto i = first; i < last; ++i) {
+                auto & elem = slice[i];
+                assert(elem.is_num() || elem.is_null_or_null_value());
+                if (!elem.is_null_or_null_value()) {
+                    auto const element_value = elem.num();
+                    values[first + p.values++] = element_value;
+                    if (!std::isnan(element_value))
+                        p.counts.add(element_value);
+                    else
+                        p.NaNs++;
+                    if (!no_mdp)
+                        p.mdp = std::max(elem.precision(), p.mdp);
+                } else
+                    p.nulls++;
+            }
+        });
+
+        std::size_t packed = 0;
+        for (auto const & p : partials) {
+            auto const chunk = values.begin() + static_cast<std::ptrdiff_t>(p.first);
+            auto const packed_values = values.begin() + static_cast<std::ptrdiff_t>(packed);
+            if (chunk != packed_values)
+                std::copy(chunk, chunk + static_cast<std::ptrdiff_t>(p.values), packed_values);
+            for (auto it = packed_values; it != packed_values + static_cast<std::ptrdiff_t>(p.values); ++it) {
+                auto const element_value = *it;
                 sum += element_value;
                 //TODO: probably 'if' would be faster
                 max_ = std::max(element_value, max_);
                 min_ = std::min(element_value, min_);
                 common_lambda(element_value);
-                if (!std::isnan(element_value))
-                    mcv_map_[element_value]++;
-                else
-                    NaNs++;
-                ++B::non_nulls();
-                mdp = mdp_calc(elem);
-            } else
-                null_number++;
-        }
-
-        long double median;
-
-        if (!null_number) {
-            auto const mm = slice.begin() + slice.size() / 2;
-            std::nth_element(slice.begin(), mm, slice.end(), [](auto &elem, auto &elem2) {
-                auto const left = elem.is_null_or_null_value() ? INFINITY : elem.num();
-                auto const right = elem2.is_null_or_null_value() ? INFINITY : elem2.num();
-                return left < right;
-            });
-
-            if (slice.size() & 1)
-                median = slice[slice.size() / 2].num();
-            else {
-                auto const _ = std::max_element(slice.begin(), slice.begin() + slice.size() / 2, [&](auto &elem, auto &elem2) {
-                    return elem.num() < elem2.num();
-                });
-                median = (slice[slice.size() / 2].num() + (*_).num()) / 2;
             }
-        } else {
-            auto const good_size = slice.size() - null_number;
-
-            std::sort(slice.begin(), slice.end(), [](auto &elem, auto &elem2) {
-                auto const left = elem.is_null_or_null_value() ? INFINITY : elem.num();
-                auto const right = elem2.is_null_or_null_value() ? INFINITY : elem2.num();
-                return left < right;
-            });
-
-            median = (good_size & 1) ? slice[good_size / 2].num() : (slice[good_size / 2].num() + slice[good_size / 2 - 1].num()) / 2.0;
+            packed += p.values;
+            p.counts.merge_into(mcv_map_);
+            B::non_nulls() += p.values;
+            null_number += p.nulls;
+            NaNs += p.NaNs;
+            mdp = std::max(mdp, p.mdp);
         }
+        values.resize(packed);
+        auto const median = median_of(values);
 
         r->smallest_value = min_;
         r->largest_value = max_;
@@ -949,6 +1065,82 @@ namespace csvstat {
         B::complete(null_number, mcv_map_, mcv_vec_);
     }
 
+    template<class B>
+    struct number_class<B>::streaming {
+        explicit streaming(std::size_t frequent_capacity) : frequent(frequent_capacity) {}
+        long double current_rolling_mean = 0, current_rolling_var = 0, current_n = 0, sum = 0;
+        long double min_ = INFINITY, max_ = -INFINITY;
+        std::size_t null_number = 0;
+        std::size_t NaNs = 0;
+        unsigned char mdp = 0;
+        sketch::distinct_counter<long double> distinct;
+        sketch::frequent_values<long double> frequent;
+        sketch::quantile_sketch<long double> quantiles;
+    };
+
+    template<class B>
+    void number_class<B>::accumulate(std::size_t rows) {
+        auto &&slice = B::dim_2().get()[B::column()];
+        if (!s)
+            s = std::make_shared<streaming>(frequent_capacity(this->args().get()));
+        bool const no_mdp = this->args().get().no_mdp;
+        for (std::size_t i = 0; i < rows; ++i) {
+            auto & elem = slice[i];
+            assert(elem.is_num() || elem.is_null_or_null_value());
+            if (!elem.is_null_or_null_value()) {
+                auto const element_value = elem.num();
+                s->sum += element_value;
+                s->max_ = std::max(element_value, s->max_);
+                s->min_ = std::min(element_value, s->min_);
+                // the very rolling mean and variance of prepare()
+                if (++s->current_n == 1)
+                    s->current_rolling_mean = element_value;
+                else {
+                    auto const delta = element_value - s->current_rolling_mean;
+                    s->current_rolling_mean += delta / s->current_n;
+                    auto const delta2 = element_value - s->current_rolling_mean;
+                    s->current_rolling_var += delta * delta2;
+                }
+                if (!std::isnan(element_value)) {
+                    s->distinct.add(element_value);
+                    s->frequent.add(element_value);
+                    s->quantiles.add(element_value);
+                } else
+                    s->NaNs++;
+                ++B::non_nulls();
+                if (!no_mdp)
+                    s->mdp = std::max(elem.precision(), s->mdp);
+            } else
+                s->null_number++;
+        }
+    }
+
+    template<class B>
+    void number_class<B>::finish() {
+        assert(s);
+        r->smallest_value = s->min_;
+        r->largest_value = s->max_;
+        r->sum = s->sum;
+        r->mean = s->current_rolling_mean;
+        r->median = s->quantiles.size() ? s->quantiles.median() : NAN;
+        r->approximate_median = !s->quantiles.exact();
+
+        if (s->current_n > 1) {
+            r->stdev = std::sqrt(s->current_rolling_var / (s->current_n - 1));
+            r->stdev_none = false;
+        } else
+        if (s->NaNs) {
+            r->stdev = NAN;
+            r->stdev_none = false;
+        } else
+            r->stdev_none = true;
+
+        r->mdp = s->mdp;
+
+        B::set_numeric_NaNs(s->NaNs);
+        B::complete_streaming(s->null_number, s->distinct, s->frequent, mcv_vec_);
+    }
+
     template<class B>
     void number_class<B>::type(std::size_t output_lines) {
         B::compose_operation_result(output_lines, "Number");
@@ -1054,42 +1246,13 @@ namespace csvstat {
     template<class B>
     void number_class<B>::median(std::size_t output_lines) {
         auto &&slice = B::dim_2().get()[B::column()];
-        std::size_t null_number = 0;
+        auto & values = median_buffer();
+        values.reserve(slice.size());
         for (auto const & elem : slice) {
-            if (elem.is_null_or_null_value())
-                null_number++;
-        }
-
-        long double median;
-
-        if (!null_number) {
-            auto const mm = slice.begin() + slice.size() / 2;
-            std::nth_element(slice.begin(), mm, slice.end(), [](auto &elem, auto &elem2) {
-                auto const left = elem.is_null_or_null_value() ? INFINITY : elem.num();
-                auto const right = elem2.is_null_or_null_value() ? INFINITY : elem2.num();
-                return left < right;
-            });
-
-            if (slice.size() & 1) {
-                median = slice[slice.size() / 2].num();
-            } else {
-                auto const _ = std::max_element(slice.begin(), slice.begin() + slice.size() / 2, [&](auto &elem, auto &elem2) {
-                    return elem.num() < elem2.num();
-                });
-                median = (slice[slice.size() / 2].num() + (*_).num()) / 2;
-            }
-        } else {
-            auto const good_size = slice.size() - null_number;
-
-            std::sort(slice.begin(), slice.end(), [](auto &elem, auto &elem2) {
-                auto const left = elem.is_null_or_null_value() ? INFINITY : elem.num();
-                auto const right = elem2.is_null_or_null_value() ? INFINITY : elem2.num();
-                return left < right;
-            });
-
-            median = (good_size & 1) ? slice[good_size / 2].num() :
-                     (slice[good_size / 2].num() + slice[good_size / 2 - 1].num()) / 2.0;
+            if (!elem.is_null_or_null_value())
+                values.push_back(elem.num());
         }
+        auto const median = median_of(values);
         B::compose_operation_result(output_lines, median);
     }
 
@@ -1221,17 +1384,36 @@ namespace csvstat {
         common_lambda = first_loop_lambda;
 
         std::size_t null_number = 0;
-        for (auto const & elem : slice) {
-            if (!elem.is_null_or_null_value()) {
-                auto const element_value = elem.timedelta_seconds();
+
+        // Chunks of the column are parsed concurrently, the values are accumulated in the row order
+        struct partial {
+            std::vector<long double> values;
+            partial_counts<decltype(mcv_map_)> counts;
+            std::size_t nulls = 0;
+        };
+        auto const partials = aggregate_chunks<partial>(slice.size(), B::column_concurrency(), [&](std::size_t first, std::size_t last, partial & p) {
+            p.values.reserve(last - first);
+            for (auto i = first; i < last; ++i) {
+                auto const & elem = slice[i];
+                if (!elem.is_null_or_null_value()) {
+                    auto const element_value = elem.timedelta_seconds();
+                    p.values.push_back(element_value);
+                    p.counts.add(element_value);
+                } else
+                    p.nulls++;
+            }
+        });
+
+        for (auto const & p : partials) {
+            for (auto const element_value : p.values) {
                 sum += element_value;
                 max_ = std::max(element_value, max_);
                 min_ = std::min(element_value, min_);
                 common_lambda(element_value);
-                mcv_map_[element_value]++;
-                ++B::non_nulls();
-            } else
-                null_number++;
+            }
+            p.counts.merge_into(mcv_map_);
+            B::non_nulls() += p.values.size();
+            null_number += p.nulls;
         }
 
         r->smallest_value = min_;
@@ -1242,6 +1424,51 @@ namespace csvstat {
         B::complete(null_number, mcv_map_, mcv_vec_);
     }
 
+    template<class B>
+    struct timedelta_class<B>::streaming {
+        explicit streaming(std::size_t frequent_capacity) : frequent(frequent_capacity) {}
+        long double current_rolling_mean = 0, current_n = 0, sum = 0;
+        long double min_ = INFINITY, max_ = -INFINITY;
+        std::size_t null_number = 0;
+        sketch::distinct_counter<long double> distinct;
+        sketch::frequent_values<long double> frequent;
+    };
+
+    template<class B>
+    void timedelta_class<B>::accumulate(std::size_t rows) {
+        auto &&slice = B::dim_2().get()[B::column()];
+        if (!s)
+            s = std::make_shared<streaming>(frequent_capacity(this->args().get()));
+        for (std::size_t i = 0; i < rows; ++i) {
+            auto const & elem = slice[i];
+            if (!elem.is_null_or_null_value()) {
+                auto const element_value = elem.timedelta_seconds();
+                s->sum += element_value;
+                s->max_ = std::max(element_value, s->max_);
+                s->min_ = std::min(element_value, s->min_);
+                if (++s->current_n == 1)
+                    s->current_rolling_mean = element_value;
+                else
+                    s->current_rolling_mean += (element_value - s->current_rolling_mean) / s->current_n;
+                s->distinct.add(element_value);
+                s->frequent.add(element_value);
+                ++B::non_nulls();
+            } else
+                s->null_number++;
+        }
+    }
+
+    template<class B>
+    void timedelta_class<B>::finish() {
+        assert(s);
+        r->smallest_value = s->min_;
+        r->largest_value = s->max_;
+        r->sum = s->sum;
+        r->mean = s->current_rolling_mean;
+
+        B::complete_streaming(s->null_number, s->distinct, s->frequent, mcv_vec_);
+    }
+
     template<class B>
     void timedelta_class<B>::type(std::size_t output_lines) {
         B::compose_operation_result(output_lines, "TimeDelta");
@@ -1353,16 +1580,57 @@ namespace csvstat {
     void bool_class<B>::prepare() {
         auto &&slice = B::dim_2().get()[B::column()];
         std::size_t null_number = 0;
-        for (auto const & e : slice) {
+        struct partial {
+            partial_counts<decltype(mcv_map_)> counts;
+            std::size_t non_nulls = 0;
+            std::size_t nulls = 0;
+        };
+        auto const partials = aggregate_chunks<partial>(slice.size(), B::column_concurrency(), [&](std::size_t first, std::size_t last, partial & p) {
+            for (auto i = first; i < last; ++i) {
+                auto const & e = slice[i];
+                if (!e.is_null_or_null_value()) {
+                    p.counts.add(static_cast<bool>(e.unsafe()));
+                    p.non_nulls++;
+                } else
+                    p.nulls++;
+                assert(e.is_boolean() || e.is_null_or_null_value());
+            }
+        });
+        for (auto const & p : partials) {
+            p.counts.merge_into(mcv_map_);
+            B::non_nulls() += p.non_nulls;
+            null_number += p.nulls;
+        }
+
+        B::complete(null_number, mcv_map_, mcv_vec_);
+    }
+
+    template<class B>
+    struct bool_class<B>::streaming {
+        std::size_t null_number = 0;
+    };
+
+    template<class B>
+    void bool_class<B>::accumulate(std::size_t rows) {
+        auto &&slice = B::dim_2().get()[B::column()];
+        if (!s)
+            s = std::make_shared<streaming>();
+        // two values only: counted exactly
+        for (std::size_t i = 0; i < rows; ++i) {
+            auto const & e = slice[i];
             if (!e.is_null_or_null_value()) {
                 mcv_map_[static_cast<bool>(e.unsafe())]++;
                 ++B::non_nulls();
             } else
-                null_number++;
+                s->null_number++;
             assert(e.is_boolean() || e.is_null_or_null_value());
         }
+    }
 
-        B::complete(null_number, mcv_map_, mcv_vec_);
+    template<class B>
+    void bool_class<B>::finish() {
+        assert(s);
+        B::complete(s->null_number, mcv_map_, mcv_vec_);
     }
 
     template<class B>
@@ -1421,18 +1689,68 @@ namespace csvstat {
         auto &&slice = B::dim_2().get()[B::column()];
         std::size_t longest_value = 0;
         std::size_t null_number = 0;
-        for (auto const & e : slice) {
+        struct partial {
+            partial_counts<decltype(mcv_map_)> counts;
+            std::size_t longest_value = 0;
+            std::size_t non_nulls = 0;
+            std::size_t nulls = 0;
+        };
+        auto const partials = aggregate_chunks<partial>(slice.size(), B::column_concurrency(), [&](std::size_t first, std::size_t last, partial & p) {
+            for (auto i = first; i < last; ++i) {
+                auto const & e = slice[i];
+                if (!B::blanks() or !e.is_null_or_null_value()) {
+                    auto const size_in_symbols = e.unsafe_str_size_in_symbols();
+                    p.longest_value = (size_in_symbols > p.longest_value) ? size_in_symbols : p.longest_value;
+                    p.counts.add(e.str());
+                    p.non_nulls++;
+                } else
+                    p.nulls++;
+                assert(e.is_str() || e.is_null_or_null_value() || e.is_boolean() || e.is_num());
+            }
+        });
+        for (auto const & p : partials) {
+            longest_value = std::max(longest_value, p.longest_value);
+            p.counts.merge_into(mcv_map_);
+            B::non_nulls() += p.non_nulls;
+            null_number += p.nulls;
+        }
+        r->longest_value = longest_value;
+        B::complete(null_number, mcv_map_, mcv_vec_);
+    }
+
+    template<class B>
+    struct text_class<B>::streaming {
+        explicit streaming(std::size_t frequent_capacity) : frequent(frequent_capacity) {}
+        std::size_t longest_value = 0;
+        std::size_t null_number = 0;
+        sketch::distinct_counter<std::string> distinct;
+        sketch::frequent_values<std::string> frequent;
+    };
+
+    template<class B>
+    void text_class<B>::accumulate(std::size_t rows) {
+        auto &&slice = B::dim_2().get()[B::column()];
+        if (!s)
+            s = std::make_shared<streaming>(frequent_capacity(this->args().get()));
+        for (std::size_t i = 0; i < rows; ++i) {
+            auto const & e = slice[i];
             if (!B::blanks() or !e.is_null_or_null_value()) {
-                auto const size_in_symbols = e.unsafe_str_size_in_symbols();
-                longest_value = (size_in_symbols > longest_value) ? size_in_symbols : longest_value;
-                mcv_map_[e.str()]++;
+                s->longest_value = std::max<std::size_t>(s->longest_value, e.unsafe_str_size_in_symbols());
+                auto const value = e.str();
+                s->distinct.add(value);
+                s->frequent.add(value);
                 ++B::non_nulls();
             } else
-                null_number++;
+                s->null_number++;
             assert(e.is_str() || e.is_null_or_null_value() || e.is_boolean() || e.is_num());
         }
-        r->longest_value = longest_value;
-        B::complete(null_number, mcv_map_, mcv_vec_);
+    }
+
+    template<class B>
+    void text_class<B>::finish() {
+        assert(s);
+        r->longest_value = s->longest_value;
+        B::complete_streaming(s->null_number, s->distinct, s->frequent, mcv_vec_);
     }
 
     template<class B>
@@ -1512,27 +1830,99 @@ namespace csvstat {
         date::sys_seconds min_value;
         std::time_t max_ = std::numeric_limits<std::time_t>::min();
         date::sys_seconds max_value;
-        for (auto const & elem : slice) {
+        struct partial {
+            partial_counts<decltype(mcv_map_)> counts;
+            std::time_t min_ = std::numeric_limits<std::time_t>::max();
+            date::sys_seconds min_value;
+            std::time_t max_ = std::numeric_limits<std::time_t>::min();
+            date::sys_seconds max_value;
+            std::size_t non_nulls = 0;
+            std::size_t nulls = 0;
+        };
+        auto const partials = aggregate_chunks<partial>(slice.size(), B::column_concurrency(), [&](std::size_t first, std::size_t last, partial & p) {
+            for (auto i = first; i < last; ++i) {
+                auto const & elem = slice[i];
+                assert(std::get<0>(elem.date()) || elem.is_null_or_null_value());
+                if (!elem.is_null_or_null_value()) {
+                    auto const elem_value = date_time_point(elem);
+                    auto e_time_t = std::chrono::system_clock::to_time_t(elem_value);
+                    if (p.max_ <= e_time_t) {
+                        p.max_ = e_time_t;
+                        p.max_value = elem_value;
+                    }
+                    if (p.min_ >= e_time_t) {
+                        p.min_ = e_time_t;
+                        p.min_value = elem_value;
+                    }
+                    p.counts.add(elem_value);
+                    p.non_nulls++;
+                } else
+                    p.nulls++;
+            }
+        });
+        for (auto const & p : partials) {
+            if (max_ <= p.max_) {
+                max_ = p.max_;
+                max_value = p.max_value;
+            }
+            if (min_ >= p.min_) {
+                min_ = p.min_;
+                min_value = p.min_value;
+            }
+            p.counts.merge_into(mcv_map_);
+            B::non_nulls() += p.non_nulls;
+            null_number += p.nulls;
+        }
+        r->largest_value = date_s(max_value);
+        r->smallest_value = date_s(min_value);
+        B::complete(null_number, mcv_map_, mcv_vec_);
+    }
+
+    template<class B>
+    struct date_class<B>::streaming {
+        explicit streaming(std::size_t frequent_capacity) : frequent(frequent_capacity) {}
+        std::time_t min_ = std::numeric_limits<std::time_t>::max();
+        date::sys_seconds min_value;
+        std::time_t max_ = std::numeric_limits<std::time_t>::min();
+        date::sys_seconds max_value;
+        std::size_t null_number = 0;
+        sketch::distinct_counter<date::sys_seconds, sys_seconds_hash> distinct;
+        sketch::frequent_values<date::sys_seconds, sys_seconds_hash> frequent;
+    };
+
+    template<class B>
+    void date_class<B>::accumulate(std::size_t rows) {
+        auto &&slice = B::dim_2().get()[B::column()];
+        if (!s)
+            s = std::make_shared<streaming>(frequent_capacity(this->args().get()));
+        for (std::size_t i = 0; i < rows; ++i) {
+            auto const & elem = slice[i];
             assert(std::get<0>(elem.date()) || elem.is_null_or_null_value());
             if (!elem.is_null_or_null_value()) {
                 auto const elem_value = date_time_point(elem);
                 auto e_time_t = std::chrono::system_clock::to_time_t(elem_value);
-                if (max_ <= e_time_t) {
-                    max_ = e_time_t;
-                    max_value = elem_value;
+                if (s->max_ <= e_time_t) {
+                    s->max_ = e_time_t;
+                    s->max_value = elem_value;
                 }
-                if (min_ >= e_time_t) {
-                    min_ = e_time_t;
-                    min_value = elem_value;
+                if (s->min_ >= e_time_t) {
+                    s->min_ = e_time_t;
+                    s->min_value = elem_value;
                 }
-                mcv_map_[elem_value]++;
+                s->distinct.add(elem_value);
+                s->frequent.add(elem_value);
                 ++B::non_nulls();
             } else
-                null_number++;
+                s->null_number++;
         }
-        r->largest_value = date_s(max_value);
-        r->smallest_value = date_s(min_value);
-        B::complete(null_number, mcv_map_, mcv_vec_);
+    }
+
+    template<class B>
+    void date_class<B>::finish() {
+        assert(s);
+        r->largest_value = date_s(s->max_value);
+        r->smallest_value = date_s(s->min_value);
+        B::complete_streaming(s->null_number, s->distinct, s->frequent, mcv_vec_);
     }
 
     template<class B>
@@ -1631,29 +2021,101 @@ namespace csvstat {
         date::sys_seconds min_value;
         std::time_t max_ = std::numeric_limits<std::time_t>::min();
         date::sys_seconds max_value;
-        for (auto const & elem : slice) {
+        struct partial {
+            partial_counts<decltype(mcv_map_)> counts;
+            std::time_t min_ = std::numeric_limits<std::time_t>::max();
+            date::sys_seconds min_value;
+            std::time_t max_ = std::numeric_limits<std::time_t>::min();
+            date::sys_seconds max_value;
+            std::size_t non_nulls = 0;
+            std::size_t nulls = 0;
+        };
+        auto const partials = aggregate_chunks<partial>(slice.size(), B::column_concurrency(), [&](std::size_t first, std::size_t last, partial & p) {
+            for (auto i = first; i < last; ++i) {
+                auto const & elem = slice[i];
+                assert(std::get<0>(elem.datetime()) || elem.is_null_or_null_value());
+                if (!elem.is_null_or_null_value()) {
+                    auto const elem_value = datetime_time_point(elem);
+                    auto e_time_t = std::chrono::system_clock::to_time_t(elem_value);
+                    if (p.max_ <= e_time_t) {
+                        p.max_ = e_time_t;
+                        p.max_value = elem_value;
+                    }
+                    if (p.min_ >= e_time_t) {
+                        p.min_ = e_time_t;
+                        p.min_value = elem_value;
+                    }
+                    p.counts.add(elem_value);
+                    p.non_nulls++;
+                } else
+                    p.nulls++;
+            }
+        });
+        for (auto const & p : partials) {
+            if (max_ <= p.max_) {
+                max_ = p.max_;
+                max_value = p.max_value;
+            }
+            if (min_ >= p.min_) {
+                min_ = p.min_;
+                min_value = p.min_value;
+            }
+            p.counts.merge_into(mcv_map_);
+            B::non_nulls() += p.non_nulls;
+            null_number += p.nulls;
+        }
+
+        r->largest_value = this->args().get().json ? datetime_s_json(max_value) : datetime_s(max_value);
+        r->smallest_value = this->args().get().json ? datetime_s_json(min_value) : datetime_s(min_value);
+
+        B::complete(null_number, mcv_map_, mcv_vec_);
+    }
+
+    template<class B>
+    struct datetime_class<B>::streaming {
+        explicit streaming(std::size_t frequent_capacity) : frequent(frequent_capacity) {}
+        std::time_t min_ = std::numeric_limits<std::time_t>::max();
+        date::sys_seconds min_value;
+        std::time_t max_ = std::numeric_limits<std::time_t>::min();
+        date::sys_seconds max_value;
+        std::size_t null_number = 0;
+        sketch::distinct_counter<date::sys_seconds, sys_seconds_hash> distinct;
+        sketch::frequent_values<date::sys_seconds, sys_seconds_hash> frequent;
+    };
+
+    template<class B>
+    void datetime_class<B>::accumulate(std::size_t rows) {
+        auto &&slice = B::dim_2().get()[B::column()];
+        if (!s)
+            s = std::make_shared<streaming>(frequent_capacity(this->args().get()));
+        for (std::size_t i = 0; i < rows; ++i) {
+            auto const & elem = slice[i];
             assert(std::get<0>(elem.datetime()) || elem.is_null_or_null_value());
             if (!elem.is_null_or_null_value()) {
                 auto const elem_value = datetime_time_point(elem);
                 auto e_time_t = std::chrono::system_clock::to_time_t(elem_value);
-                if (max_ <= e_time_t) {
-                    max_ = e_time_t;
-                    max_value = elem_value;
+                if (s->max_ <= e_time_t) {
+                    s->max_ = e_time_t;
+                    s->max_value = elem_value;
                 }
-                if (min_ >= e_time_t) {
-                    min_ = e_time_t;
-                    min_value = elem_value;
+                if (s->min_ >= e_time_t) {
+                    s->min_ = e_time_t;
+                    s->min_value = elem_value;
                 }
-                mcv_map_[elem_value]++;
+                s->distinct.add(elem_value);
+                s->frequent.add(elem_value);
                 ++B::non_nulls();
             } else
-                null_number++;
+                s->null_number++;
         }
+    }
 
-        r->largest_value = this->args().get().json ? datetime_s_json(max_value) : datetime_s(max_value);
-        r->smallest_value = this->args().get().json ? datetime_s_json(min_value) : datetime_s(min_value);
-
-        B::complete(null_number, mcv_map_, mcv_vec_);
+    template<class B>
+    void datetime_class<B>::finish() {
+        assert(s);
+        r->largest_value = this->args().get().json ? datetime_s_json(s->max_value) : datetime_s(s->max_value);
+        r->smallest_value = this->args().get().json ? datetime_s_json(s->min_value) : datetime_s(s->min_value);
+        B::complete_streaming(s->null_number, s->distinct, s->frequent, mcv_vec_);
     }
 
     template<class B>
@@ -1733,12 +2195,31 @@ namespace csvstat {
         B::compose_operation_result(output_lines, "{ " + mcv(*this, freq_none_print, freq_space_print, &value_caller) + " }");
     }
 
+    /// Marks a statistic estimated with --streaming
+    inline char const * approximate_mark(bool approximate) {
+        return approximate ? " (approximate)" : "";
+    }
+
+    /// Lists the statistics estimated with --streaming as a JSON member
+    std::string approximate_json(auto const & o, std::string const & indent) {
+        std::string fields;
+        auto add = [&](bool approximate, char const * name) {
+            if (approximate)
+                fields += (fields.empty() ? "\"" : ", \"") + std::string(name) + '"';
+        };
+        add(o.approximate_unique(), "unique");
+        if constexpr (requires { o.r->approximate_median; })
+            add(o.r->approximate_median, "median");
+        add(o.approximate_freq(), "freq");
+        return fields.empty() ? std::string{} : indent + R"("approximate": [)" + fields + "], ";
+    }
+
     /// Prints most common values
     template <typename ObjectType, typename NonePrintFun, typename SpacePrintFun, class Variant>
     [[nodiscard]] auto mcv(ObjectType const& o, NonePrintFun none_print_fun, SpacePrintFun space_print_fun, Variant const & vo) {
 
         std::ostringstream oss;
-        if (o.mcv_map().empty() && o.nulls()) {
+        if (std::none_of(o.mcv_vec().begin(), o.mcv_vec().end(), [](auto const & e) { return e.second; }) && o.nulls()) {
             if constexpr (!std::is_same_v<typename std::decay_t<decltype(*vo)>::visitor_type, json_print_visitor>)
                 none_print_fun(oss, o);
             else
@@ -1790,6 +2271,11 @@ namespace csvstat {
 
     struct standard_print_visitor::rep {
         using visitor_type = standard_print_visitor;
+        /// A count of a most common value which may overestimate
+        static char const * count_mark(auto const & o) {
+            return o.approximate_freq() ? "~" : "";
+        }
+
         template <class T>
         auto to_strm(std::ostringstream & oss, auto const & elem, bool_class<T> const &) const {
             oss.imbue(std::locale(std::locale(), new custom_boolean_facet));
@@ -1799,28 +2285,28 @@ namespace csvstat {
         template <class T>
         auto to_strm(std::ostringstream & oss, auto const & elem, timedelta_class<T> const & o) const {
             tune_ostream(oss, o.args().get());
-            to_stream(oss, csv_co::time_storage().str(elem.first), " (", std::to_string(elem.second), "x)", '\n');
+            to_stream(oss, csv_co::time_storage().str(elem.first), " (", count_mark(o), std::to_string(elem.second), "x)", '\n');
         }
 
         template <class T>
         auto to_strm(std::ostringstream & oss, auto const & elem, number_class<T> const & o) const {
             tune_ostream(oss, o.args().get());
-            to_stream(oss, spec_prec(elem.first), " (", std::to_string(elem.second), "x)", '\n');
+            to_stream(oss, spec_prec(elem.first), " (", count_mark(o), std::to_string(elem.second), "x)", '\n');
         }
 
         template <class T>
-        auto to_strm(std::ostringstream & oss, auto const & elem, text_class<T> const &) const {
-            to_stream(oss, elem.first, " (", std::to_string(elem.second), "x)", '\n');
+        auto to_strm(std::ostringstream & oss, auto const & elem, text_class<T> const & o) const {
+            to_stream(oss, elem.first, " (", count_mark(o), std::to_string(elem.second), "x)", '\n');
         }
 
         template <class T>
-        auto to_strm(std::ostringstream & oss, auto const & elem, date_class<T> const &) const {
-            to_stream(oss, date_s(elem.first), " (", std::to_string(elem.second), "x)", '\n');
+        auto to_strm(std::ostringstream & oss, auto const & elem, date_class<T> const & o) const {
+            to_stream(oss, date_s(elem.first), " (", count_mark(o), std::to_string(elem.second), "x)", '\n');
         }
 
         template <class T>
-        auto to_strm(std::ostringstream & oss, auto const & elem, datetime_class<T> const &) const {
-            to_stream(oss, datetime_s(elem.first), " (", std::to_string(elem.second), "x)", '\n');
+        auto to_strm(std::ostringstream & oss, auto const & elem, datetime_class<T> const & o) const {
+            to_stream(oss, datetime_s(elem.first), " (", count_mark(o), std::to_string(elem.second), "x)", '\n');
         }
 
         void print_col_header(auto const & o) {
@@ -1845,9 +2331,9 @@ namespace csvstat {
         prep->print_col_header(o);
         to_stream(std::cout, "\n\n\tType of data:          Number", "\n\tContains null values:  ", std::boolalpha, o.nulls() > 0
                   , (o.nulls() ? " (excluded from calculations)\n" : "\n"), "\tNon-null values:       ", o.non_nulls()
-                  , "\n\tUnique values:         ", o.uniques(), "\n\tSmallest value:        ", spec_prec(o.r->smallest_value)
+                  , "\n\tUnique values:         ", o.uniques(), approximate_mark(o.approximate_unique()), "\n\tSmallest value:        ", spec_prec(o.r->smallest_value)
                   , "\n\tLargest value:         ", spec_prec(o.r->largest_value), "\n\tSum:                   ", spec_prec(o.r->sum)
-                  , "\n\tMean:                  ", spec_prec(o.r->mean), "\n\tMedian:                ", spec_prec(o.r->median));
+                  , "\n\tMean:                  ", spec_prec(o.r->mean), "\n\tMedian:                ", spec_prec(o.r->median), approximate_mark(o.r->approximate_median));
         if (!o.r->stdev_none)
             to_stream(std::cout, "\n\tStDev:                 ", spec_prec(o.r->stdev));
         if (!o.args().get().no_mdp)
@@ -1860,7 +2346,7 @@ namespace csvstat {
         prep->print_col_header(o);
         to_stream(std::cout, "\n\n\tType of data:          Boolean", "\n\tContains null values:  ", std::boolalpha, o.nulls() > 0
                   , (o.nulls() ? " (excluded from calculations)\n" : "\n"), "\tNon-null values:       ", o.non_nulls()
-                  , "\n\tUnique values:         ", o.uniques(), "\n\tMost common values:    ", mcv(o, standard_none_print, standard_space_print, prep), '\n');
+                  , "\n\tUnique values:         ", o.uniques(), approximate_mark(o.approximate_unique()), "\n\tMost common values:    ", mcv(o, standard_none_print, standard_space_print, prep), '\n');
     }
 
     template<class T>
@@ -1868,7 +2354,7 @@ namespace csvstat {
         prep->print_col_header(o);
         to_stream(std::cout, "\n\n\tType of data:          TimeDelta", "\n\tContains null values:  ", std::boolalpha, o.nulls() > 0
                 , (o.nulls() ? " (excluded from calculations)\n" : "\n"), "\tNon-null values:       ", o.non_nulls()
-                , "\n\tUnique values:         ", o.uniques()
+                , "\n\tUnique values:         ", o.uniques(), approximate_mark(o.approximate_unique())
                 , "\n\tSmallest value:        ", csv_co::time_storage().str(o.r->smallest_value)
                 , "\n\tLargest value:         ", csv_co::time_storage().str(o.r->largest_value)
                 , "\n\tSum:                   ", csv_co::time_storage().str(o.r->sum)
@@ -1881,7 +2367,7 @@ namespace csvstat {
         prep->print_col_header(o);
         to_stream(std::cout, "\n\n\tType of data:          Text", "\n\tContains null values:  ", std::boolalpha, o.nulls() > 0
                   , (o.nulls() ? " (excluded from calculations)\n" : "\n"), "\tNon-null values:       ", o.non_nulls()
-                  , "\n\tUnique values:         ", o.uniques(), "\n\tLongest value:         ", o.r->longest_value, " characters"
+                  , "\n\tUnique values:         ", o.uniques(), approximate_mark(o.approximate_unique()), "\n\tLongest value:         ", o.r->longest_value, " characters"
                   , "\n\tMost common values:    ", mcv(o, standard_none_print, standard_space_print, prep), '\n');
     }
 
@@ -1890,7 +2376,7 @@ namespace csvstat {
         prep->print_col_header(o);
         to_stream(std::cout, "\n\n\tType of data:          Date", "\n\tContains null values:  ", std::boolalpha, o.nulls() > 0
                   , (o.nulls() ? " (excluded from calculations)\n" : "\n"), "\tNon-null values:       ", o.non_nulls()
-                  , "\n\tUnique values:         ", o.uniques(), "\n\tSmallest value:        ", o.r->smallest_value
+                  , "\n\tUnique values:         ", o.uniques(), approximate_mark(o.approximate_unique()), "\n\tSmallest value:        ", o.r->smallest_value
                   , "\n\tLargest value:         ", o.r->largest_value, "\n\tMost common values:    ",  mcv(o, standard_none_print, standard_space_print, prep), '\n');
     }
 
@@ -1899,7 +2385,7 @@ namespace csvstat {
         prep->print_col_header(o);
         to_stream(std::cout, "\n\n\tType of data:          DateTime", "\n\tContains null values:  ", std::boolalpha, o.nulls() > 0
                   , (o.nulls() ? " (excluded from calculations)\n" : "\n"), "\tNon-null values:       ", o.non_nulls()
-                  , "\n\tUnique values:         ", o.uniques(), "\n\tSmallest value:        ", o.r->smallest_value
+                  , "\n\tUnique values:         ", o.uniques(), approximate_mark(o.approximate_unique()), "\n\tSmallest value:        ", o.r->smallest_value
                   , "\n\tLargest value:         ", o.r->largest_value, "\n\tMost common values:    ",  mcv(o, standard_none_print, standard_space_print, prep), '\n');
     }
 
@@ -2239,7 +2725,7 @@ namespace csvstat {
                   , prep->add_indent(), R"("type": "Number")", ", "
                   , prep->add_indent(), R"("nulls": )", std::boolalpha, o.nulls() > 0, ", "
                   , prep->add_indent(), R"("nonnulls": )", o.non_nulls(), ", "
-                  , prep->add_indent(), R"("unique": )", o.uniques(), ", ");
+                  , prep->add_indent(), R"("unique": )", o.uniques(), ", ", approximate_json(o, prep->add_indent()));
 
         auto format_value = [&](auto const & value) -> std::variant<char const*, long double> {
             if (std::isnan(value))
@@ -2273,7 +2759,7 @@ namespace csvstat {
                   , prep->add_indent(), R"("type": "Boolean")", ", "
                   , prep->add_indent(), R"("nulls": )", std::boolalpha, o.nulls() > 0, ", "
                   , prep->add_indent(), R"("nonnulls": )", o.non_nulls(), ", "
-                  , prep->add_indent(), R"("unique": )", o.uniques(), ", "
+                  , prep->add_indent(), R"("unique": )", o.uniques(), ", ", approximate_json(o, prep->add_indent())
                   , prep->add_indent(), R"("freq": )", '[', mcv(o, json_none_print, json_space_print, prep), prep->add_indent(), ']');
         prep->dec_indent();
     }
@@ -2288,7 +2774,7 @@ namespace csvstat {
                 , prep->add_indent(), R"("type": "TimeDelta")", ", "
                 , prep->add_indent(), R"("nulls": )", std::boolalpha, o.nulls() > 0, ", "
                 , prep->add_indent(), R"("nonnulls": )", o.non_nulls(), ", "
-                , prep->add_indent(), R"("unique": )", o.uniques(), ", "
+                , prep->add_indent(), R"("unique": )", o.uniques(), ", ", approximate_json(o, prep->add_indent())
                 , prep->add_indent(), R"("min": )", std::quoted(csv_co::time_storage().str(o.r->smallest_value)), ", "
                 , prep->add_indent(), R"("max": )", std::quoted(csv_co::time_storage().str(o.r->largest_value)), ", "
                 , prep->add_indent(), R"("sum": )", std::quoted(csv_co::time_storage().str(o.r->sum)), ", "
@@ -2307,7 +2793,7 @@ namespace csvstat {
                   , prep->add_indent(), R"("type": "Text")", ", "
                   , prep->add_indent(), R"("nulls": )", std::boolalpha, o.nulls() > 0, ", "
                   , prep->add_indent(), R"("nonnulls": )", o.non_nulls(), ", "
-                  , prep->add_indent(), R"("unique": )", o.uniques(), ", "
+                  , prep->add_indent(), R"("unique": )", o.uniques(), ", ", approximate_json(o, prep->add_indent())
                   , prep->add_indent(), R"("len": )", o.r->longest_value, ", "
                   , prep->add_indent(), R"("freq": )", '[', mcv(o, json_none_print, json_space_print, prep), prep->add_indent(), ']');
         prep->dec_indent();
@@ -2323,7 +2809,7 @@ namespace csvstat {
                   , prep->add_indent(), R"("type": "Date")", ", "
                   , prep->add_indent(), R"("nulls": )", std::boolalpha, o.nulls() > 0, ", "
                   , prep->add_indent(), R"("nonnulls": )", o.non_nulls(), ", "
-                  , prep->add_indent(), R"("unique": )", o.uniques(), ", "
+                  , prep->add_indent(), R"("unique": )", o.uniques(), ", ", approximate_json(o, prep->add_indent())
                   , prep->add_indent(), R"("min": )", std::quoted(o.r->smallest_value), ", "
                   , prep->add_indent(), R"("max": )", std::quoted(o.r->largest_value), ", "
                   , prep->add_indent(), R"("freq": )", '[', mcv(o, json_none_print, json_space_print, prep), prep->add_indent(), ']');
@@ -2340,7 +2826,7 @@ namespace csvstat {
                 , prep->add_indent(), R"("type": "DateTime")", ", "
                 , prep->add_indent(), R"("nulls": )", std::boolalpha, o.nulls() > 0, ", "
                 , prep->add_indent(), R"("nonnulls": )", o.non_nulls(), ", "
-                , prep->add_indent(), R"("unique": )", o.uniques(), ", "
+                , prep->add_indent(), R"("unique": )", o.uniques(), ", ", approximate_json(o, prep->add_indent())
                 , prep->add_indent(), R"("min": )", std::quoted(o.r->smallest_value), ", "
                 , prep->add_indent(), R"("max": )", std::quoted(o.r->largest_value), ", "
                 , prep->add_indent(), R"("freq": )", '[', mcv(o, json_none_print, json_space_print, prep), prep->add_indent(), ']');
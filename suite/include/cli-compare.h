@@ -5,6 +5,12 @@
 
 #pragma once
 
+#include <array>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include "../external/poolstl/poolstl.hpp"
+
 namespace csvsuite::cli::compare::detail {
 
     template <class EType, class Native>
@@ -281,6 +287,20 @@ namespace csvsuite::cli::compare {
         sort_comparator(column_fun_tuple<ElemType> cf, CPP_COMP cmp) : compare_fun_(std::move(cf)), cpp_cmp(std::move(cmp)) {}
     };
 
+    /// Rewinds the reader before and after a table takes the body of it
+    template <class R, class Args, bool HibernateToFirstRow>
+    struct table_hibernator {
+        explicit table_hibernator(R & reader, Args const & args) : reader_(reader), args_(args) { reader_.skip_rows(0); }
+        ~table_hibernator() {
+            reader_.skip_rows(0);
+            if constexpr(HibernateToFirstRow)
+                obtain_header_and_<skip_header>(reader_, args_);
+        }
+    private:
+        R & reader_;
+        Args const & args_;
+    };
+
     template <class R, class Args, bool HibernateToFirstRow = false, bool Quoted_or_not=csv_co::quoted>
     class compromise_table_MxN {
     public:
@@ -293,17 +313,7 @@ namespace csvsuite::cli::compare {
         explicit compromise_table_MxN(R & reader, Args const & args) {
             using namespace csv_co;
 
-            struct hibernator {
-                explicit hibernator(R & reader, Args const & args) : reader_(reader), args_(args) { reader_.skip_rows(0); }
-                ~hibernator() {
-                    reader_.skip_rows(0);
-                    if constexpr(HibernateToFirstRow)
-                        obtain_header_and_<skip_header>(reader_, args_);
-                }
-            private:
-                R & reader_;
-                Args const & args_;
-            } h(reader, args);
+            table_hibernator<R, Args, HibernateToFirstRow> h(reader, args);
 
             skip_lines(reader, args);
             auto const rest_rows = reader.rows() - (args.no_header ? 0 : 1);
@@ -325,6 +335,9 @@ namespace csvsuite::cli::compare {
         decltype (auto) operator[](size_t r) {
             return (*impl)[r];
         }
+        decltype (auto) operator[](size_t r) const {
+            return (*impl)[r];
+        }
         [[nodiscard]] auto rows() const {
             return (*impl).size();
         }
@@ -336,12 +349,100 @@ namespace csvsuite::cli::compare {
         [[nodiscard]] auto cend() const { return impl->cend(); }
         auto begin() { return impl->begin(); }
         auto end() { return impl->end(); }
+
         compromise_table_MxN (compromise_table_MxN && other) noexcept = default;
         auto operator=(compromise_table_MxN && other) noexcept -> compromise_table_MxN & = default;
     };
     static_assert(!std::is_copy_constructible<compromise_table_MxN<csv_co::reader<>,ARGS>>::value);
     static_assert(std::is_move_constructible<compromise_table_MxN<csv_co::reader<>,ARGS>>::value);
 
+    /// Cells of a table kept row after row in a single buffer, a row being a view of its cells.
+    /// The rows are never moved: a sort orders a permutation of the row numbers, and the output walks it.
+    template <class Elem>
+    class cell_arena_MxN {
+    public:
+        using element_type = Elem;
+
+        /// Cells of a row
+        template <class Cell>
+        class basic_row_view {
+        public:
+            basic_row_view(Cell * first, std::size_t size) noexcept : first_(first), size_(size) {}
+            [[nodiscard]] Cell * begin() const noexcept { return first_; }
+            [[nodiscard]] Cell * end() const noexcept { return first_ + size_; }
+            [[nodiscard]] std::size_t size() const noexcept { return size_; }
+            Cell & operator[](std::size_t i) const noexcept { return first_[i]; }
+            Cell & at(std::size_t i) const {
+                if (i >= size_)
+                    throw std::out_of_range("cell_arena_MxN row: no such column");
+                return first_[i];
+            }
+            Cell & front() const noexcept { return *first_; }
+            Cell & back() const noexcept { return first_[size_ - 1]; }
+        private:
+            Cell * first_;
+            std::size_t size_;
+        };
+        using row_view = basic_row_view<Elem>;
+        using const_row_view = basic_row_view<Elem const>;
+
+        cell_arena_MxN() = default;
+
+        /// An empty table to append rows to
+        explicit cell_arena_MxN(std::size_t columns) : columns_(columns) {}
+
+        /// The whole body of the reader, as compromise_table_MxN takes it
+        template <class R, class Args>
+        cell_arena_MxN(R & reader, Args const & args) {
+            table_hibernator<R, Args, false> h(reader, args);
+
+            skip_lines(reader, args);
+            auto const rest_rows = reader.rows() - (args.no_header ? 0 : 1);
+            columns_ = obtain_header_and_<skip_header>(reader, args).size();
+            if (!rest_rows)
+                throw no_body_exception("cell_arena_MxN constructor. No data rows.", static_cast<unsigned>(columns_));
+
+            cells_.reserve(rest_rows * columns_);
+            reader.run_rows([&] (auto & row_span) {
+                append(row_span);
+            });
+        }
+
+        template <class Row>
+        void append(Row const & row) {
+            for (auto & elem : row)
+                cells_.emplace_back(elem);
+        }
+
+        void clear() noexcept {
+            cells_.clear();
+        }
+
+        row_view operator[](std::size_t r) noexcept {
+            return {cells_.data() + r * columns_, columns_};
+        }
+        const_row_view operator[](std::size_t r) const noexcept {
+            return {cells_.data() + r * columns_, columns_};
+        }
+        [[nodiscard]] std::size_t rows() const noexcept {
+            return columns_ ? cells_.size() / columns_ : 0;
+        }
+        [[nodiscard]] std::size_t cols() const noexcept {
+            return columns_;
+        }
+
+        /// All the cells, row after row
+        auto begin() { return cells_.begin(); }
+        auto end() { return cells_.end(); }
+
+    private:
+        std::size_t columns_ {0};
+        std::vector<Elem> cells_;
+    };
+
+    template <class R, class Args>
+    cell_arena_MxN(R &, Args const &) -> cell_arena_MxN<typename std::decay_t<R>::template typed_span<csv_co::quoted>>;
+
     template <typename R>
     using typed_span_t = typename R::template typed_span<csv_co::quoted>;
 
@@ -370,5 +471,538 @@ namespace csvsuite::cli::compare {
         compare_fun<typed_span_t<R>> cmp_func;
     };
 
-}
 
+    /// Runs f(first, last) over consecutive ranges of [0, n), a range a task, and a task for min_size items at least
+    inline void for_each_range(std::size_t n, std::size_t min_size, auto && f) {
+        auto const tasks = std::clamp<std::size_t>(n / min_size, 1, std::max(1u, std::thread::hardware_concurrency()));
+        auto const task_size = (n + tasks - 1) / tasks;
+        if (tasks == 1) {
+            f(std::size_t{0}, n);
+            return;
+        }
+        std::vector<std::size_t> task_numbers(tasks);
+        std::iota(task_numbers.begin(), task_numbers.end(), 0);
+        transwarp::parallel exec(tasks);
+        auto task = transwarp::for_each(exec, task_numbers.cbegin(), task_numbers.cend(), [&](auto t) {
+            f(t * task_size, std::min(n, (t + 1) * task_size));
+        });
+        task->wait();
+    }
+
+    /// Key values of a table column parsed once per run and kept column-wise: numbers (booleans and timedeltas
+    /// in seconds as well), epoch ticks of dates and datetimes, views of texts, and a bitmap of nulls. It compares
+    /// two rows the very way the compare_fun of the column would compare their cells, without parsing them again.
+    class typed_column {
+    public:
+        template <class Table>
+        typed_column(Table & table, unsigned column, column_type type, bool has_blanks, auto const & args) {
+            if constexpr (requires { args.ignore_case; })
+                ignore_case_ = args.ignore_case;
+            // the same dispatch as common_compare_impl does
+            bool native = true;
+            if (!args.no_inference && !has_blanks)
+                nulls_last_ = false;
+            else if (!args.blanks && !args.no_inference && has_blanks)
+                nulls_last_ = true;
+            else if (!args.blanks && args.no_inference && has_blanks) {
+                nulls_last_ = true;
+                native = false;
+            } else {
+                nulls_last_ = false;
+                native = false;
+            }
+            kind_ = !native || type == column_type::text_t ? kind::text
+                  : (type == column_type::datetime_t || type == column_type::date_t ? kind::ticks : kind::number);
+            type_ = type;
+            if (kind_ == kind::ticks)
+                format_ = type == column_type::datetime_t ? args.datetime_fmt : args.date_fmt;
+
+            auto const rows = table.rows();
+            switch (kind_) {
+                case kind::number: numbers_.resize(rows); break;
+                case kind::ticks: ticks_.resize(rows); break;
+                case kind::text:
+                    texts_.resize(rows);
+                    if (ignore_case_)
+                        folded_texts_.resize(rows);
+                    break;
+            }
+            null_bits_.resize((rows + 63) / 64);
+
+            // a task fills the values and the bitmap words of a range of 64 row blocks
+            for_each_range(null_bits_.size(), 1024, [&](std::size_t first_word, std::size_t last_word) {
+                for (auto w = first_word; w < last_word; ++w) {
+                    std::uint64_t bits = 0;
+                    for (auto r = w * 64; r < std::min(rows, (w + 1) * 64); ++r) {
+                        auto & elem = table[r][column];
+                        using UElemType = typename std::decay_t<decltype(elem)>::template rebind<csv_co::unquoted>::other;
+                        auto const & ue = elem.operator UElemType const&();
+                        if (nulls_last_ && ue.is_null_or_null_value()) {
+                            bits |= std::uint64_t{1} << (r % 64);
+                            continue;
+                        }
+                        if (kind_ == kind::text) {
+                            texts_[r] = text_key(ue.raw_string_view());
+                            if (ignore_case_)
+                                texts_[r] = folded_texts_[r] = fold_case(texts_[r]);
+                        }
+                        else if (kind_ == kind::number)
+                            numbers_[r] = number_of(ue);
+                        else
+                            ticks_[r] = ticks_of(ue);
+                    }
+                    null_bits_[w] = bits;
+                }
+            });
+        }
+
+        [[nodiscard]] bool is_null(std::size_t row) const noexcept {
+            return null_bits_[row / 64] & (std::uint64_t{1} << (row % 64));
+        }
+
+        /// Compares the cells of two rows: a negative, zero or positive result, nulls being the greatest
+        [[nodiscard]] int compare(std::size_t row1, std::size_t row2) const {
+            if (nulls_last_) {
+                auto const n1 = is_null(row1);
+                auto const n2 = is_null(row2);
+                if (n1 || n2)
+                    return n1 && n2 ? 0 : (n1 ? 1 : -1);
+            }
+            switch (kind_) {
+                case kind::number: {
+                    // NaNs are equal to each other and follow every number, as radix_key() and encode() order them
+                    auto const nan1 = std::isnan(numbers_[row1]);
+                    auto const nan2 = std::isnan(numbers_[row2]);
+                    if (nan1 || nan2)
+                        return nan1 && nan2 ? 0 : (nan1 ? 1 : -1);
+                    return three_way(numbers_[row1], numbers_[row2]);
+                }
+                case kind::ticks:
+                    return three_way(ticks_[row1], ticks_[row2]);
+                default:
+                    // with -i the texts are already case-folded
+                    return texts_[row1].compare(texts_[row2]);
+            }
+        }
+
+        /// The cells of two rows are equal, as the compare_fun of the column finds them: a NaN equals nothing
+        [[nodiscard]] bool equal(std::size_t row1, std::size_t row2) const {
+            if (nulls_last_ && (is_null(row1) || is_null(row2)))
+                return is_null(row1) && is_null(row2);
+            switch (kind_) {
+                case kind::number:
+                    return numbers_[row1] == numbers_[row2];
+                case kind::ticks:
+                    return ticks_[row1] == ticks_[row2];
+                default:
+                    return texts_[row1] == texts_[row2];
+            }
+        }
+
+        /// A cell of another table equals the cell of a row. The cell is read the way the cells of the column were.
+        template <class Elem>
+        [[nodiscard]] bool equal(Elem const & cell, std::size_t row) const {
+            using UElemType = typename Elem::template rebind<csv_co::unquoted>::other;
+            auto const & ue = cell.operator UElemType const&();
+            if (nulls_last_) {
+                auto const cell_is_null = ue.is_null_or_null_value();
+                if (cell_is_null || is_null(row))
+                    return cell_is_null && is_null(row);
+            }
+            switch (kind_) {
+                case kind::number:
+                    return number_of(ue) == numbers_[row];
+                case kind::ticks:
+                    return ticks_of(ue) == ticks_[row];
+                default: {
+                    auto const text = text_key(ue.raw_string_view());
+                    return ignore_case_ ? fold_case(text) == texts_[row] : text == texts_[row];
+                }
+            }
+        }
+
+        /// The column has radix_key(): dates, datetimes, or numbers all exactly representable as double
+        [[nodiscard]] bool has_radix_key() const {
+            if (kind_ == kind::ticks)
+                return true;
+            if (kind_ != kind::number)
+                return false;
+            for (std::size_t r = 0; r < numbers_.size(); ++r) {
+                auto const v = numbers_[r];
+                if (!std::isnan(v) && static_cast<long double>(static_cast<double>(v)) != v && !(nulls_last_ && is_null(r)))
+                    return false;
+            }
+            return true;
+        }
+
+        /// A non-null cell as an unsigned number ordered as compare() orders the cells
+        [[nodiscard]] std::uint64_t radix_key(std::size_t row) const noexcept {
+            constexpr auto sign_bit = std::uint64_t{1} << 63;
+            if (kind_ == kind::ticks)
+                return static_cast<std::uint64_t>(ticks_[row]) ^ sign_bit;
+            auto v = static_cast<double>(numbers_[row]);
+            if (std::isnan(v))
+                v = std::numeric_limits<double>::quiet_NaN(); // all NaNs are equal and the greatest
+            else if (v == 0)
+                v = 0; // so is -0 to 0
+            std::uint64_t bits;
+            std::memcpy(&bits, &v, sizeof(bits));
+            return bits & sign_bit ? ~bits : bits | sign_bit;
+        }
+
+        /// Size of the binary key of a row cell, see encode()
+        [[nodiscard]] std::size_t key_size(std::size_t row) const noexcept {
+            std::size_t size = nulls_last_ ? 1 : 0;
+            if (nulls_last_ && is_null(row))
+                return size;
+            switch (kind_) {
+                case kind::number: return size + number_key_size;
+                case kind::ticks: return size + sizeof(std::uint64_t);
+                default: return size + texts_[row].size() + std::count(texts_[row].begin(), texts_[row].end(), '\0') + 2;
+            }
+        }
+
+        /// Writes the binary key of a row cell: memcmp() of two keys orders them as compare() does (the reverse
+        /// way when descending). The keys are prefix-free, so the keys of several columns may follow each other.
+        unsigned char * encode(std::size_t row, unsigned char * out, bool descending) const noexcept {
+            auto const first = out;
+            auto put_big_endian = [&](std::uint64_t v, unsigned bytes) {
+                for (auto i = bytes; i--;)
+                    *out++ = static_cast<unsigned char>(v >> (i * 8));
+            };
+            if (nulls_last_)
+                *out++ = is_null(row) ? 1 : 0;
+            if (!nulls_last_ || !is_null(row)) {
+                switch (kind_) {
+                    case kind::number: {
+                        // class, then exponent and mantissa of the magnitude (inverted for negatives)
+                        auto const v = numbers_[row];
+                        unsigned char cls;
+                        int exp = 0;
+                        std::array<std::uint64_t, mantissa_words> mantissa {};
+                        if (std::isnan(v))
+                            cls = 5;
+                        else if (std::isinf(v))
+                            cls = v < 0 ? 0 : 4;
+                        else if (v == 0)
+                            cls = 2;
+                        else {
+                            cls = v < 0 ? 1 : 3;
+                            // all the mantissa digits as an integer, taken 64 bits at a time from the most significant
+                            auto rest = std::ldexp(std::frexp(std::abs(v), &exp), mantissa_digits);
+                            for (std::size_t w = 0; w < mantissa_words; ++w) {
+                                auto const shift = static_cast<int>(64 * (mantissa_words - 1 - w));
+                                mantissa[w] = static_cast<std::uint64_t>(std::ldexp(rest, -shift));
+                                rest -= std::ldexp(static_cast<long double>(mantissa[w]), shift);
+                            }
+                        }
+                        auto biased_exp = static_cast<std::uint32_t>(static_cast<std::int64_t>(exp) + 0x80000000ll);
+                        if (cls == 1) {
+                            biased_exp = ~biased_exp;
+                            for (auto & word : mantissa)
+                                word = ~word;
+                        }
+                        *out++ = cls;
+                        put_big_endian(biased_exp, 4);
+                        for (auto word : mantissa)
+                            put_big_endian(word, 8);
+                        break;
+                    }
+                    case kind::ticks:
+                        put_big_endian(static_cast<std::uint64_t>(ticks_[row]) ^ (std::uint64_t{1} << 63), 8);
+                        break;
+                    default:
+                        // zero bytes are escaped, the terminator sorts a prefix first
+                        for (auto c : texts_[row]) {
+                            *out++ = static_cast<unsigned char>(c);
+                            if (c == '\0')
+                                *out++ = 0xff;
+                        }
+                        *out++ = 0;
+                        *out++ = 0;
+                }
+            }
+            if (descending)
+                std::transform(first, out, first, [](unsigned char c) { return static_cast<unsigned char>(~c); });
+            return out;
+        }
+
+    private:
+        enum class kind {
+            number,
+            ticks,
+            text
+        };
+
+        static constexpr int mantissa_digits = std::numeric_limits<long double>::digits;
+        static constexpr std::size_t mantissa_words = (mantissa_digits + 63) / 64;
+        static constexpr std::size_t number_key_size = 1 + 4 + 8 * mantissa_words;
+
+        template <typename T>
+        static int three_way(T const & e1, T const & e2) noexcept {
+            return e1 == e2 ? 0 : (e1 < e2 ? -1 : 1);
+        }
+
+        /// A number, a boolean or timedelta seconds of a cell
+        [[nodiscard]] long double number_of(auto const & ue) const {
+            if (type_ == column_type::bool_t)
+                return (ue.is_boolean(), static_cast<bool>(ue.unsafe()));
+            if (type_ == column_type::timedelta_t)
+                return ue.timedelta_seconds();
+            return ue.num();
+        }
+
+        /// Epoch ticks of a date or a datetime cell
+        [[nodiscard]] std::int64_t ticks_of(auto const & ue) const {
+            if (type_ == column_type::datetime_t)
+                return static_cast<std::int64_t>(std::get<1>(ue.datetime(format_)).time_since_epoch().count());
+            return static_cast<std::int64_t>(std::get<1>(ue.date(format_)).time_since_epoch().count());
+        }
+
+        /// The part of a cell text_compare() compares
+        static std::string_view text_key(std::string_view sv) noexcept {
+            auto const b = sv.find_first_not_of('"');
+            if (b == std::string_view::npos)
+                return {};
+            auto const e = sv.find_last_not_of("\"\t\r");
+            if (e == std::string_view::npos)
+                return {};
+            return sv.substr(b, e - b + 1);
+        }
+
+        /// Lower-cases a UTF-8 text the way StrCiCmpUtf8() does before comparing
+        static std::string fold_case(std::string_view sv) {
+            std::string result(sv);
+            if (std::all_of(sv.begin(), sv.end(), [](char c) { return static_cast<unsigned char>(c) < 0x80; })) {
+                for (auto & c : result)
+                    c = c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+                return result;
+            }
+            if (auto lower = Utf8StrMakeLwrUtf8Str(reinterpret_cast<unsigned char const *>(result.c_str()))) {
+                result = reinterpret_cast<char const *>(lower);
+                free(lower);
+            }
+            return result;
+        }
+
+        kind kind_ {kind::text};
+        column_type type_ {column_type::text_t};
+        std::string format_;
+        bool nulls_last_ {false};
+        bool ignore_case_ {false};
+        std::vector<long double> numbers_;
+        std::vector<std::int64_t> ticks_;
+        std::vector<std::string_view> texts_;
+        std::vector<std::string> folded_texts_;
+        std::vector<std::uint64_t> null_bits_;
+    };
+
+    /// Binary sort keys of the table rows, encoded once and kept in a single buffer. A key is the concatenation
+    /// of the typed_column keys of a row, so that plain byte comparison gives the order of all the key columns.
+    class sort_keys {
+    public:
+        sort_keys(std::vector<typed_column> const & columns, std::size_t rows, bool descending) : offsets_(rows + 1) {
+            for_each_range(rows, 65536, [&](std::size_t first, std::size_t last) {
+                for (auto r = first; r < last; ++r) {
+                    std::size_t size = 0;
+                    for (auto const & c : columns)
+                        size += c.key_size(r);
+                    offsets_[r + 1] = size;
+                }
+            });
+            std::partial_sum(offsets_.begin(), offsets_.end(), offsets_.begin());
+
+            bytes_.resize(offsets_.back());
+            for_each_range(rows, 65536, [&](std::size_t first, std::size_t last) {
+                for (auto r = first; r < last; ++r) {
+                    auto out = bytes_.data() + offsets_[r];
+                    for (auto const & c : columns)
+                        out = c.encode(r, out, descending);
+                    assert(out == bytes_.data() + offsets_[r + 1]);
+                }
+            });
+        }
+
+        [[nodiscard]] std::string_view operator[](std::size_t row) const noexcept {
+            return {reinterpret_cast<char const *>(bytes_.data()) + offsets_[row], offsets_[row + 1] - offsets_[row]};
+        }
+
+        /// The first 8 bytes of a key as a number, zero padded: equal prefixes are only to be compared further
+        [[nodiscard]] std::uint64_t prefix(std::size_t row) const noexcept {
+            std::uint64_t result = 0;
+            auto const key = (*this)[row];
+            for (std::size_t i = 0; i < 8; ++i)
+                result = (result << 8) | (i < key.size() ? static_cast<unsigned char>(key[i]) : 0u);
+            return result;
+        }
+
+        [[nodiscard]] std::size_t rows() const noexcept {
+            return offsets_.size() - 1;
+        }
+
+    private:
+        std::vector<unsigned char> bytes_;
+        std::vector<std::size_t> offsets_;
+    };
+
+    /// Sorts the rows by a single column with radix_key(): a stable LSD radix sort of the keys, a byte per pass,
+    /// with per-task histograms. Nulls are a bucket of their own, after the others (before them when descending),
+    /// and descending order flips the key bits. Equal keys keep the order of rows, as sorted_rows() does.
+    inline std::vector<std::size_t> radix_sorted_rows(typed_column const & column, std::size_t rows, bool descending, bool parallel) {
+        std::vector<std::uint64_t> keys;
+        std::vector<std::size_t> order;
+        std::vector<std::size_t> nulls;
+        keys.reserve(rows);
+        order.reserve(rows);
+        for (std::size_t r = 0; r < rows; ++r) {
+            if (column.is_null(r))
+                nulls.push_back(r);
+            else {
+                keys.push_back(descending ? ~column.radix_key(r) : column.radix_key(r));
+                order.push_back(r);
+            }
+        }
+
+        auto const n = keys.size();
+        auto const tasks = parallel ? std::clamp<std::size_t>(n / 65536, 1, std::max(1u, std::thread::hardware_concurrency())) : 1;
+        auto const task_size = (n + tasks - 1) / tasks;
+        std::vector<std::size_t> task_numbers(tasks);
+        std::iota(task_numbers.begin(), task_numbers.end(), 0);
+        transwarp::parallel exec(tasks);
+
+        std::vector<std::uint64_t> keys_buffer(n);
+        std::vector<std::size_t> order_buffer(n);
+        std::vector<std::array<std::size_t, 256>> histograms(tasks);
+        for (unsigned shift = 0; shift < 64; shift += 8) {
+            auto count = transwarp::for_each(exec, task_numbers.cbegin(), task_numbers.cend(), [&](auto t) {
+                auto & h = histograms[t];
+                h.fill(0);
+                for (auto i = t * task_size; i < std::min(n, (t + 1) * task_size); ++i)
+                    ++h[(keys[i] >> shift) & 0xff];
+            });
+            count->wait();
+
+            // a byte all the keys share does not reorder anything
+            std::size_t offset = 0;
+            bool trivial = false;
+            for (unsigned digit = 0; digit < 256; ++digit) {
+                std::size_t digit_count = 0;
+                for (auto & h : histograms) {
+                    auto const c = h[digit];
+                    h[digit] = offset;
+                    offset += c;
+                    digit_count += c;
+                }
+                trivial = trivial || digit_count == n;
+            }
+            if (trivial)
+                continue;
+
+            auto scatter = transwarp::for_each(exec, task_numbers.cbegin(), task_numbers.cend(), [&](auto t) {
+                auto & h = histograms[t];
+                for (auto i = t * task_size; i < std::min(n, (t + 1) * task_size); ++i) {
+                    auto const pos = h[(keys[i] >> shift) & 0xff]++;
+                    keys_buffer[pos] = keys[i];
+                    order_buffer[pos] = order[i];
+                }
+            });
+            scatter->wait();
+            keys.swap(keys_buffer);
+            order.swap(order_buffer);
+        }
+
+        order.insert(descending ? order.begin() : order.end(), nulls.begin(), nulls.end());
+        return order;
+    }
+
+    /// A key prefix paired with its row: the most of the comparisons never leave this array
+    struct keyed_row {
+        std::uint64_t prefix;
+        std::size_t row;
+    };
+
+    /// Orders keyed rows by their keys, then by their row numbers
+    class keyed_row_less {
+    public:
+        explicit keyed_row_less(sort_keys const & keys) noexcept : keys_(keys) {}
+        bool operator()(keyed_row const & a, keyed_row const & b) const noexcept {
+            if (a.prefix != b.prefix)
+                return a.prefix < b.prefix;
+            if (auto const result = keys_[a.row].compare(keys_[b.row]))
+                return result < 0;
+            return a.row < b.row;
+        }
+    private:
+        sort_keys const & keys_;
+    };
+
+    inline std::vector<keyed_row> keyed_rows(sort_keys const & keys) {
+        std::vector<keyed_row> pairs(keys.rows());
+        for (std::size_t r = 0; r < pairs.size(); ++r)
+            pairs[r] = {keys.prefix(r), r};
+        return pairs;
+    }
+
+    inline std::vector<std::size_t> row_numbers(std::vector<keyed_row> const & pairs) {
+        std::vector<std::size_t> order(pairs.size());
+        std::transform(pairs.begin(), pairs.end(), order.begin(), [](keyed_row const & p) { return p.row; });
+        return order;
+    }
+
+    /// Sorts the rows by their keys, equal keys keep the order of rows
+    inline std::vector<std::size_t> sorted_rows(sort_keys const & keys, bool parallel) {
+        auto pairs = keyed_rows(keys);
+        keyed_row_less const less(keys);
+        if (parallel)
+            std::sort(poolstl::par, pairs.begin(), pairs.end(), less);
+        else
+            std::sort(pairs.begin(), pairs.end(), less);
+        return row_numbers(pairs);
+    }
+
+    /// The first (or the last, from_end) count rows of sorted_rows(), in the same order, without sorting the rest.
+    /// Every task keeps the best count rows of its part, and the candidates of all the tasks are sorted at last.
+    inline std::vector<std::size_t> top_rows(sort_keys const & keys, std::size_t count, bool from_end, bool parallel) {
+        auto pairs = keyed_rows(keys);
+        count = std::min(count, pairs.size());
+        keyed_row_less const less(keys);
+        // the last rows are the first ones the reverse way
+        auto const before = [&](keyed_row const & a, keyed_row const & b) {
+            return from_end ? less(b, a) : less(a, b);
+        };
+        auto const best = [&](auto first, auto last) {
+            if (static_cast<std::size_t>(last - first) > count)
+                std::nth_element(first, first + static_cast<std::ptrdiff_t>(count), last, before);
+            return std::min(last, first + static_cast<std::ptrdiff_t>(count));
+        };
+
+        auto const tasks = parallel ? std::clamp<std::size_t>(pairs.size() / std::max<std::size_t>(65536, 4 * count), 1
+                                                              , std::max(1u, std::thread::hardware_concurrency())) : 1;
+        std::vector<keyed_row> candidates;
+        if (tasks == 1)
+            candidates.assign(pairs.begin(), best(pairs.begin(), pairs.end()));
+        else {
+            auto const task_size = (pairs.size() + tasks - 1) / tasks;
+            std::vector<std::size_t> task_numbers(tasks);
+            std::iota(task_numbers.begin(), task_numbers.end(), 0);
+            std::vector<std::size_t> kept(tasks);
+            transwarp::parallel exec(tasks);
+            auto select = transwarp::for_each(exec, task_numbers.cbegin(), task_numbers.cend(), [&](auto t) {
+                auto const first = pairs.begin() + static_cast<std::ptrdiff_t>(std::min(pairs.size(), t * task_size));
+                auto const last = pairs.begin() + static_cast<std::ptrdiff_t>(std::min(pairs.size(), (t + 1) * task_size));
+                kept[t] = static_cast<std::size_t>(best(first, last) - first);
+            });
+            select->wait();
+            for (std::size_t t = 0; t < tasks; ++t) {
+                auto const first = pairs.begin() + static_cast<std::ptrdiff_t>(std::min(pairs.size(), t * task_size));
+                candidates.insert(candidates.end(), first, first + static_cast<std::ptrdiff_t>(kept[t]));
+            }
+            candidates.erase(best(candidates.begin(), candidates.end()), candidates.end());
+        }
+        std::sort(candidates.begin(), candidates.end(), before);
+        if (from_end)
+            std::reverse(candidates.begin(), candidates.end());
+        return row_numbers(candidates);
+    }
+
+}
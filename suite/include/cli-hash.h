@@ -4,6 +4,8 @@
 /// \brief  All possible hash classes, operations: type-aware and type-independent.
 
 #pragma once
+#include <bit>
+#include <span>
 #include "cli-compare.h"
 
 namespace csvsuite::cli::hash::detail {
@@ -201,104 +203,379 @@ namespace csvsuite::cli::hash {
         return result;
     }
 
-    template <class E, class ComparePair>
-    class equality_checker {
-        std::decay_t<decltype(std::get<1>(std::declval<ComparePair>()))> c_lang_compare_function;
+    /// The standard hashes of numbers are the numbers themselves: spreads them over all the bits (the MurmurHash3 finalizer)
+    inline std::uint64_t spread_hash(std::size_t h) noexcept {
+        std::uint64_t x = h;
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdull;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ull;
+        x ^= x >> 33;
+        return x;
+    }
+
+    /// A split block Bloom filter of 64-bit key hashes. A key sets one bit in every 32-bit word of a single 256-bit
+    /// block, so a lookup costs a single cache line access. Sixteen bits a key leave well under one percent of false
+    /// positives.
+    class blocked_bloom_filter {
     public:
-        bool is_equal(auto & this_one, auto & other) const {
-            int result;
-            std::visit([&](auto & arg) {
-                result = arg(this_one, other);
-            }, c_lang_compare_function);
-            return result == 0;
-        }
-        // only getting function from a column-function pair
-        equality_checker(ComparePair & compare_pair) : c_lang_compare_function(std::get<1>(compare_pair)) {}
+        blocked_bloom_filter() = default;
+        explicit blocked_bloom_filter(std::size_t keys) : blocks_(std::max<std::size_t>(1, (keys + 15) / 16)) {}
+
+        void insert(std::uint64_t h) noexcept {
+            auto & b = blocks_[block_of(h)];
+            for (unsigned i = 0; i < 8; ++i)
+                b.words[i] |= bit_of(h, i);
+        }
+
+        /// False if the key is certainly absent
+        [[nodiscard]] bool may_contain(std::uint64_t h) const noexcept {
+            auto const & b = blocks_[block_of(h)];
+            for (unsigned i = 0; i < 8; ++i)
+                if (!(b.words[i] & bit_of(h, i)))
+                    return false;
+            return true;
+        }
+
+    private:
+        struct alignas(32) block {
+            std::uint32_t words[8] {};
+        };
+
+        /// The block is chosen by the high half of the hash, the bits by the low one
+        [[nodiscard]] std::size_t block_of(std::uint64_t h) const noexcept {
+            return static_cast<std::size_t>(((h >> 32) * blocks_.size()) >> 32);
+        }
+        static std::uint32_t bit_of(std::uint64_t h, unsigned word) noexcept {
+            static constexpr std::uint32_t salts[8] {0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du, 0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u};
+            return std::uint32_t{1} << ((static_cast<std::uint32_t>(h) * salts[word]) >> 27);
+        }
+
+        std::vector<block> blocks_;
     };
 
-    // E -- typed_span
-    template<class E, class ComparePair>
-    struct Hashable : E {
-        bool operator==(Hashable const& other) const {
-#if TRACE_
-            std::cerr << "bool operator==(Hashable)\n";
-#endif
-            assert(eq_checker);
-            auto result = eq_checker->is_equal(*this, other);
-#if TRACE_
-            std::cerr << "bool operator==(Hashable) finished\n";
-#endif
-            return result;
+    /// Combines the hash of one more key cell into the hash of a key (the boost::hash_combine mix)
+    inline std::size_t hash_combine(std::size_t h, std::size_t cell_hash) noexcept {
+        return h ^ (cell_hash + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2));
+    }
+
+    /// The key of a row: its cells in the key columns, as cells of the key type
+    template <class E, class Row>
+    class row_key {
+    public:
+        row_key(Row row, std::span<unsigned const> columns) noexcept : row_(std::forward<Row>(row)), columns_(columns) {}
+
+        [[nodiscard]] std::size_t size() const noexcept {
+            return columns_.size();
         }
-        static void create_equality_checker(ComparePair compare_functionality) {
-            eq_checker = std::make_unique<equality_checker<E, ComparePair>> (compare_functionality);
+        decltype(auto) operator[](std::size_t i) const {
+            if constexpr (std::is_same_v<std::decay_t<decltype(row_[0])>, E>)
+                return (row_[columns_[i]]);
+            else
+                return E{row_[columns_[i]]};
         }
+
     private:
-        inline static std::unique_ptr<equality_checker<E, ComparePair>> eq_checker = nullptr;
+        Row row_;
+        std::span<unsigned const> columns_;
     };
-    template <class E>
-    using hashable_typed_span = Hashable<E, column_fun_tuple<E>>;
-
-    template<class E, class ComparePair, class HashFun>
-    struct Hash
-    {
-        std::size_t operator()(Hashable<E, ComparePair> const & value) const noexcept
-        {
-#if TRACE_
-            std::cerr << "std::size_t operator()(Hashable)\n";
-#endif
-            std::size_t result;
-            std::visit([&](auto & arg) {
-                result = arg(value);
-            }, hashfun);
-#if TRACE_
-            std::cerr << "std::size_t operator()(Hashable) finished\n";
-#endif
-            return result;
+
+    /// Rows of the build side sharing a key, in input order
+    template <class Rows>
+    class key_rows {
+    public:
+        key_rows() = default;
+        key_rows(Rows const & rows, std::span<std::size_t const> ids) noexcept : rows_(&rows), ids_(ids) {}
+
+        [[nodiscard]] std::size_t size() const noexcept {
+            return ids_.size();
         }
-        static void assign_hash_function(HashFun value) {
-            hashfun = std::move(value);
+        [[nodiscard]] bool empty() const noexcept {
+            return ids_.empty();
         }
+        auto operator[](std::size_t i) const noexcept {
+            return (*rows_)[ids_[i]];
+        }
+        /// Numbers of the rows in the build side
+        [[nodiscard]] std::span<std::size_t const> ids() const noexcept {
+            return ids_;
+        }
+
     private:
-        inline static HashFun hashfun;
+        Rows const * rows_ {nullptr};
+        std::span<std::size_t const> ids_;
     };
 
-    template<class E>
-    using hash_ = Hash<E, column_fun_tuple<E>, hash_fun<E>>;
+    /// A flat open-addressing (linear probing) hash table over the key columns. A slot keeps the 64-bit key hash and
+    /// a key group, and a group keeps the numbers of the rows having that key. The typed hashes of the key cells are
+    /// combined into the key hash, and keys are equal if their cells compare equal column by column. The rows themselves are kept once,
+    /// in a cell arena, and their key cells are parsed once into typed columns, which the probed keys are compared with. Lookups never modify the table, so any number of threads may probe it.
+    /// A large table is split into partitions by the top bits of the key hashes: the keys are hashed and dealt out
+    /// slice by slice, and every partition is built on its own, concurrently. A lookup goes to the partition its
+    /// hash bits name.
+    template <class E>
+    class flat_key_index {
+    public:
+        using rows_type = cell_arena_MxN<E>;
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+        /// What find() gives: a key group and its rows as the "second", as a map does
+        class const_iterator {
+        public:
+            using value_type = std::pair<std::size_t, key_rows<rows_type>>;
+            const_iterator() = default;
+            explicit const_iterator(value_type value) noexcept : value_(std::move(value)) {}
+            value_type const * operator->() const noexcept {
+                return &value_;
+            }
+            value_type const & operator*() const noexcept {
+                return value_;
+            }
+            bool operator==(const_iterator const & other) const noexcept {
+                return value_.first == other.value_.first;
+            }
+        private:
+            value_type value_ {npos, {}};
+        };
+
+        flat_key_index() = default;
+
+        flat_key_index(rows_type rows, unsigned column, hash_fun<E> hash, typed_column key_column)
+                : flat_key_index(std::move(rows), std::vector<unsigned>{column}, std::vector<hash_fun<E>>{std::move(hash)}
+                                 , make_key_columns(std::move(key_column))) {}
+
+        /// A composite key: a hash and a typed column of the rows for each key column
+        flat_key_index(rows_type rows, std::vector<unsigned> columns, std::vector<hash_fun<E>> cell_hashes, std::vector<typed_column> key_columns)
+                : rows_(std::move(rows)), columns_(std::move(columns)), hashes_(std::move(cell_hashes)), key_columns_(std::move(key_columns)) {
+            assert(!columns_.empty() && hashes_.size() == columns_.size() && key_columns_.size() == columns_.size());
+            auto const n = rows_.rows();
+            auto const tasks = std::clamp<std::size_t>(n / 65536, 1, std::max(1u, std::thread::hardware_concurrency()));
+            auto const task_size = (n + tasks - 1) / tasks;
+            // a few partitions a task, for the builds to balance
+            partition_bits_ = tasks > 1 ? static_cast<unsigned>(std::bit_width(4 * tasks - 1)) : 0;
+            auto const partitions = std::size_t{1} << partition_bits_;
+            std::vector<std::size_t> task_numbers(tasks);
+            std::iota(task_numbers.begin(), task_numbers.end(), 0);
+            transwarp::parallel exec(tasks);
+
+            std::vector<std::uint64_t> hashes(n);
+            std::vector<std::vector<std::size_t>> counts(tasks, std::vector<std::size_t>(partitions));
+            auto hashing = transwarp::for_each(exec, task_numbers.cbegin(), task_numbers.cend(), [&](auto t) {
+                for (auto r = t * task_size; r < std::min(n, (t + 1) * task_size); ++r) {
+                    hashes[r] = key_hash(key_of(r));
+                    ++counts[t][partition_of(hashes[r])];
+                }
+            });
+            hashing->wait();
+
+            // the rows of a partition follow each other, in input order
+            std::vector<std::size_t> starts(partitions + 1);
+            std::size_t offset = 0;
+            for (std::size_t p = 0; p < partitions; ++p) {
+                starts[p] = offset;
+                for (auto & c : counts) {
+                    auto const count = c[p];
+                    c[p] = offset;
+                    offset += count;
+                }
+            }
+            starts[partitions] = n;
+            std::vector<std::size_t> partition_rows(n);
+            auto dealing = transwarp::for_each(exec, task_numbers.cbegin(), task_numbers.cend(), [&](auto t) {
+                for (auto r = t * task_size; r < std::min(n, (t + 1) * task_size); ++r)
+                    partition_rows[counts[t][partition_of(hashes[r])]++] = r;
+            });
+            dealing->wait();
+
+            partitions_.resize(partitions);
+            std::vector<std::size_t> partition_numbers(partitions);
+            std::iota(partition_numbers.begin(), partition_numbers.end(), 0);
+            auto building = transwarp::for_each(exec, partition_numbers.cbegin(), partition_numbers.cend(), [&](auto p) {
+                build(partitions_[p], std::span<std::size_t const>(partition_rows.data() + starts[p], starts[p + 1] - starts[p]), hashes);
+            });
+            building->wait();
+
+            for (auto & part : partitions_) {
+                part.first_group = groups_;
+                groups_ += part.first_rows.size();
+            }
+        }
+
+        /// The hash a key is looked up by. A key is anything giving its cells by key column number, as a row_key does.
+        template <class Key>
+        [[nodiscard]] std::uint64_t key_hash(Key const & key) const {
+            std::size_t h = 0;
+            for (std::size_t i = 0; i < columns_.size(); ++i) {
+                std::size_t cell_hash;
+                std::visit([&](auto & f) {
+                    cell_hash = f(key[i]);
+                }, hashes_[i]);
+                h = i ? hash_combine(h, cell_hash) : cell_hash;
+            }
+            return spread_hash(h);
+        }
+        /// The hash a key cell of a single key column is looked up by
+        [[nodiscard]] std::uint64_t key_hash(E const & key) const {
+            return key_hash(std::span<E const>(&key, 1));
+        }
+
+        template <class Key>
+        [[nodiscard]] const_iterator find(Key const & key) const {
+            return find(key, key_hash(key));
+        }
+
+        template <class Key>
+        [[nodiscard]] const_iterator find(Key const & key, std::uint64_t h) const {
+            if (partitions_.empty())
+                return cend();
+            auto const & part = partitions_[partition_of(h)];
+            auto const mask = part.slots.size() - 1;
+            for (auto i = h & mask; part.slots[i].group != npos; i = (i + 1) & mask) {
+                auto const group = part.slots[i].group;
+                if (part.slots[i].hash == h && equal(key, part.first_rows[group])) {
+                    std::span<std::size_t const> const ids(part.group_rows.data() + part.group_offsets[group], part.group_offsets[group + 1] - part.group_offsets[group]);
+                    return const_iterator({part.first_group + group, key_rows<rows_type>(rows_, ids)});
+                }
+            }
+            return cend();
+        }
+
+        [[nodiscard]] const_iterator find(E const & key) const {
+            return find(std::span<E const>(&key, 1));
+        }
+        [[nodiscard]] const_iterator find(E const & key, std::uint64_t h) const {
+            return find(std::span<E const>(&key, 1), h);
+        }
+
+        [[nodiscard]] const_iterator cend() const noexcept {
+            return {};
+        }
+        [[nodiscard]] const_iterator end() const noexcept {
+            return {};
+        }
+
+        /// Number of distinct keys
+        [[nodiscard]] std::size_t size() const noexcept {
+            return groups_;
+        }
+
+        [[nodiscard]] rows_type const & rows() const noexcept {
+            return rows_;
+        }
+
+        /// A Bloom filter of the keys, so that lookups of mostly absent keys can reject them early
+        [[nodiscard]] blocked_bloom_filter key_filter() const {
+            blocked_bloom_filter filter(groups_);
+            for (auto const & part : partitions_)
+                for (auto const & s : part.slots)
+                    if (s.group != npos)
+                        filter.insert(s.hash);
+            return filter;
+        }
 
-    template<class E>
-    using field_array = std::vector<E>;
+    private:
+        struct slot {
+            std::uint64_t hash {0};
+            std::size_t group {npos};
+        };
 
-    template<class E>
-    using hash_map_value = std::vector<field_array<E>>;
+        /// The table of the keys whose hashes share the top bits
+        struct partition {
+            std::vector<slot> slots;
+            std::vector<std::size_t> first_rows;
+            std::vector<std::size_t> group_offsets;
+            std::vector<std::size_t> group_rows;
+            std::size_t first_group {0};
+        };
 
-    template<class E>
-    using hash_map = std::unordered_map<hashable_typed_span<E>, hash_map_value<E>, hash_<E>>;
+        [[nodiscard]] std::size_t partition_of(std::uint64_t h) const noexcept {
+            return partition_bits_ ? static_cast<std::size_t>(h >> (64 - partition_bits_)) : 0;
+        }
+
+        /// Every row gets its group, a group is represented by its first row
+        void build(partition & part, std::span<std::size_t const> rows, std::vector<std::uint64_t> const & hashes) const {
+            std::size_t capacity = 16;
+            while (capacity < 2 * rows.size())
+                capacity *= 2;
+            part.slots.assign(capacity, slot{});
+
+            std::vector<std::size_t> row_groups(rows.size());
+            std::vector<std::size_t> group_sizes;
+            for (std::size_t k = 0; k < rows.size(); ++k) {
+                auto const r = rows[k];
+                auto const h = hashes[r];
+                auto i = h & (capacity - 1);
+                for (; part.slots[i].group != npos; i = (i + 1) & (capacity - 1)) {
+                    if (part.slots[i].hash == h && same_key(r, part.first_rows[part.slots[i].group]))
+                        break;
+                }
+                if (part.slots[i].group == npos) {
+                    part.slots[i] = {h, part.first_rows.size()};
+                    part.first_rows.push_back(r);
+                    group_sizes.push_back(0);
+                }
+                row_groups[k] = part.slots[i].group;
+                ++group_sizes[part.slots[i].group];
+            }
+
+            // the rows of a group follow each other, in input order
+            part.group_offsets.resize(group_sizes.size() + 1);
+            std::partial_sum(group_sizes.begin(), group_sizes.end(), part.group_offsets.begin() + 1);
+            part.group_rows.resize(rows.size());
+            auto next = part.group_offsets;
+            for (std::size_t k = 0; k < rows.size(); ++k)
+                part.group_rows[next[row_groups[k]]++] = rows[k];
+        }
+
+        [[nodiscard]] row_key<E, typename rows_type::const_row_view> key_of(std::size_t r) const noexcept {
+            return {rows_[r], columns_};
+        }
+
+        /// The key equals the key of the row
+        template <class Key>
+        bool equal(Key const & key, std::size_t r) const {
+            for (std::size_t i = 0; i < key_columns_.size(); ++i)
+                if (!key_columns_[i].equal(key[i], r))
+                    return false;
+            return true;
+        }
+
+        /// Two rows have the same key
+        [[nodiscard]] bool same_key(std::size_t r1, std::size_t r2) const {
+            return std::all_of(key_columns_.begin(), key_columns_.end(), [&](auto const & c) { return c.equal(r1, r2); });
+        }
+
+        static std::vector<typed_column> make_key_columns(typed_column key_column) {
+            std::vector<typed_column> result;
+            result.push_back(std::move(key_column));
+            return result;
+        }
+
+        rows_type rows_;
+        std::vector<unsigned> columns_;
+        std::vector<hash_fun<E>> hashes_;
+        std::vector<typed_column> key_columns_;
+        unsigned partition_bits_ {0};
+        std::vector<partition> partitions_;
+        std::size_t groups_ {0};
+    };
 
     template <class R, class Args, bool HibernateToFirstRow = false, bool Quoted_or_not=csv_co::quoted>
     class compromise_hash {
     public:
         using typed_span = typename std::decay_t<R>::template typed_span<Quoted_or_not>;
-        using key_type = hashable_typed_span<typed_span>;
-        using value_type = hash_map_value<typed_span>;
-        using hashing = hash_<typed_span>;
+        using key_type = typed_span;
     private:
-        hash_map<typed_span> map_;
+        flat_key_index<typed_span> index_;
     public:
-        explicit compromise_hash(R & reader, Args const & args, auto const & types_blanks, unsigned hash_column) {
+        explicit compromise_hash(R & reader, Args const & args, auto const & types_blanks, unsigned hash_column)
+            : compromise_hash(reader, args, types_blanks, std::vector<unsigned>{hash_column}) {}
+
+        /// A composite key over the hash columns
+        explicit compromise_hash(R & reader, Args const & args, auto const & types_blanks, std::vector<unsigned> const & hash_columns) {
             using namespace csv_co;
 
-            struct hibernator {
-                explicit hibernator(R & reader, Args const & args) : reader_(reader), args_(args) { reader_.skip_rows(0); }
-                ~hibernator() {
-                    reader_.skip_rows(0);
-                    if constexpr(HibernateToFirstRow)
-                        obtain_header_and_<skip_header>(reader_, args_);
-                }
-            private:
-                R & reader_;
-                Args const & args_;
-            } h(reader, args);
+            table_hibernator<R, Args, HibernateToFirstRow> h(reader, args);
 
             skip_lines(reader, args);
             auto const rest_rows = reader.rows() - (args.no_header ? 0 : 1);
@@ -306,27 +583,24 @@ namespace csvsuite::cli::hash {
             if (!rest_rows)
                 throw no_body_exception("compromise_hash constructor. No data rows.", static_cast<unsigned>(header_size));
 
-            key_type::create_equality_checker(obtain_compare_functionality<typed_span>(hash_column, types_blanks, args));
-
-            hashing::assign_hash_function(obtain_hash_functionality<typed_span>(hash_column, types_blanks, args));
-
-            key_type key;
-            field_array<typed_span> row;
-
+            cell_arena_MxN<typed_span> rows(header_size);
             reader.run_rows([&] (auto & row_span) {
-                unsigned i = 0;
-                for (auto & elem : row_span) {
-                    if (i++ == hash_column)
-                        key = key_type{typed_span{elem}};
-                    row.push_back(typed_span{elem});
-                }
-                assert(row.size() == std::get<0>(types_blanks).size());
-                map_[key].push_back(std::move(row));
+                rows.append(row_span);
             });
+            assert(rows.cols() == std::get<0>(types_blanks).size());
+
+            using index_type = flat_key_index<typed_span>;
+            std::vector<hash_fun<typed_span>> hashes;
+            std::vector<typed_column> key_columns;
+            for (auto column : hash_columns) {
+                hashes.push_back(obtain_hash_functionality<typed_span>(column, types_blanks, args));
+                key_columns.emplace_back(rows, column, std::get<0>(types_blanks)[column], std::get<1>(types_blanks)[column], args);
+            }
+            index_ = index_type(std::move(rows), hash_columns, std::move(hashes), std::move(key_columns));
         }
 
         auto const & hash() const {
-            return map_;
+            return index_;
         }
     };
 
@@ -0,0 +1,254 @@
+///
+/// \file   suite/include/cli-sketch.h
+/// \author wiluite
+/// \brief  Bounded-memory summaries of value streams: distinct counts, frequent values and quantiles.
+
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace csvsuite::cli::sketch {
+
+    /// Mixes the bits of a value hash (the murmur3 finalizer): std::hash is an identity for integers
+    constexpr std::uint64_t mix(std::uint64_t h) noexcept {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    /// Counts distinct values. The count is exact while there are at most exact_limit values, and beyond that it is
+    /// estimated by a HyperLogLog of 2^14 registers, with a standard error of about 0.8%.
+    template <class T, class Hash = std::hash<T>>
+    class distinct_counter {
+    public:
+        static constexpr std::size_t exact_limit = 1 << 16;
+
+        void add(T const & value) {
+            if (registers_.empty()) {
+                values_.insert(value);
+                if (values_.size() > exact_limit) {
+                    registers_.resize(std::size_t{1} << precision);
+                    for (auto const & e : values_)
+                        add_hash(mix(Hash{}(e)));
+                    values_ = {};
+                }
+            } else
+                add_hash(mix(Hash{}(value)));
+        }
+
+        [[nodiscard]] bool exact() const noexcept {
+            return registers_.empty();
+        }
+
+        [[nodiscard]] std::size_t count() const {
+            if (exact())
+                return values_.size();
+            auto const m = static_cast<double>(registers_.size());
+            double sum = 0;
+            std::size_t zeros = 0;
+            for (auto r : registers_) {
+                sum += std::ldexp(1.0, -r);
+                zeros += !r;
+            }
+            auto const estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+            // linear counting is the better estimate of small cardinalities
+            if (estimate <= 2.5 * m && zeros)
+                return static_cast<std::size_t>(std::llround(m * std::log(m / static_cast<double>(zeros))));
+            return static_cast<std::size_t>(std::llround(estimate));
+        }
+
+    private:
+        static constexpr unsigned precision = 14;
+
+        /// The register is chosen by the high bits of the hash, and keeps the longest run of leading zeroes of the rest
+        void add_hash(std::uint64_t h) noexcept {
+            auto & r = registers_[h >> (64 - precision)];
+            auto const rank = static_cast<std::uint8_t>(std::countl_zero((h << precision) | (std::uint64_t{1} << (precision - 1))) + 1);
+            r = std::max(r, rank);
+        }
+
+        std::unordered_set<T, Hash> values_;
+        std::vector<std::uint8_t> registers_;
+    };
+
+    /// The most frequent values by the Space-Saving algorithm with a fixed number of counters. While no more distinct
+    /// values come than there are counters, all the counts are exact. After that a new value takes over the counter of
+    /// the least frequent one, count included, so a count may overestimate, but never underestimates, and every value
+    /// occurring more than n / capacity times keeps its counter.
+    template <class T, class Hash = std::hash<T>>
+    class frequent_values {
+    public:
+        explicit frequent_values(std::size_t capacity) : capacity_(std::max<std::size_t>(1, capacity)) {}
+
+        void add(T const & value) {
+            if (auto const it = slots_.find(value); it != slots_.end()) {
+                ++heap_[it->second].count;
+                sift_down(it->second);
+            } else if (heap_.size() < capacity_) {
+                auto & node = *slots_.emplace(value, heap_.size()).first;
+                heap_.push_back({1, &node});
+                sift_up(heap_.size() - 1);
+            } else {
+                auto const count = heap_.front().count;
+                slots_.erase(heap_.front().node->first);
+                heap_.front() = {count + 1, &*slots_.emplace(value, 0).first};
+                sift_down(0);
+                evicted_ = true;
+            }
+        }
+
+        [[nodiscard]] bool exact() const noexcept {
+            return !evicted_;
+        }
+
+        /// The values kept, with their counts, in no particular order
+        [[nodiscard]] std::vector<std::pair<T, std::size_t>> counts() const {
+            std::vector<std::pair<T, std::size_t>> result;
+            result.reserve(heap_.size());
+            for (auto const & e : heap_)
+                result.emplace_back(e.node->first, e.count);
+            return result;
+        }
+
+    private:
+        using map_type = std::unordered_map<T, std::size_t, Hash>;
+
+        /// A min-heap of the counters, each knowing the map node of its value, the node knowing the heap position
+        struct counter {
+            std::size_t count;
+            typename map_type::value_type * node;
+        };
+
+        void place(std::size_t i, counter const & c) noexcept {
+            heap_[i] = c;
+            c.node->second = i;
+        }
+
+        void sift_up(std::size_t i) noexcept {
+            auto const c = heap_[i];
+            for (; i && c.count < heap_[(i - 1) / 2].count; i = (i - 1) / 2)
+                place(i, heap_[(i - 1) / 2]);
+            place(i, c);
+        }
+
+        void sift_down(std::size_t i) noexcept {
+            auto const c = heap_[i];
+            for (;;) {
+                auto child = 2 * i + 1;
+                if (child >= heap_.size())
+                    break;
+                if (child + 1 < heap_.size() && heap_[child + 1].count < heap_[child].count)
+                    ++child;
+                if (heap_[child].count >= c.count)
+                    break;
+                place(i, heap_[child]);
+                i = child;
+            }
+            place(i, c);
+        }
+
+        std::size_t capacity_;
+        map_type slots_;
+        std::vector<counter> heap_;
+        bool evicted_ {false};
+    };
+
+    /// Quantiles by a KLL sketch (Karnin, Lang, Liberty). Items come to the level 0 buffer. A full level is sorted and
+    /// compacted: every other item of it, from a random offset, goes to the next level with twice the weight. Lower
+    /// levels get geometrically smaller capacities, so the sketch keeps O(k) items while the rank error stays about
+    /// 1.7 / k. Until the first compaction the quantiles are exact.
+    template <class T>
+    class quantile_sketch {
+    public:
+        explicit quantile_sketch(std::size_t k = 2048) : k_(k), levels_(1), capacity_(capacity()) {}
+
+        void add(T const & value) {
+            levels_[0].push_back(value);
+            ++size_;
+            if (++held_ >= capacity_)
+                compress();
+        }
+
+        [[nodiscard]] bool exact() const noexcept {
+            return levels_.size() == 1;
+        }
+
+        [[nodiscard]] std::uint64_t size() const noexcept {
+            return size_;
+        }
+
+        /// The median; the mean of the two middle items for an even count, as the exact median is
+        [[nodiscard]] T median() const {
+            assert(size_);
+            std::vector<std::pair<T, std::uint64_t>> items;
+            items.reserve(held_);
+            for (std::size_t h = 0; h < levels_.size(); ++h)
+                for (auto const & e : levels_[h])
+                    items.emplace_back(e, std::uint64_t{1} << h);
+            std::sort(items.begin(), items.end(), [](auto const & a, auto const & b) { return a.first < b.first; });
+            // the item of the given rank among the weighted ones
+            auto at = [&](std::uint64_t rank) {
+                std::uint64_t below = 0;
+                for (auto const & [value, weight] : items) {
+                    if (rank < (below += weight))
+                        return value;
+                }
+                return items.back().first;
+            };
+            return (size_ & 1) ? at(size_ / 2) : (at(size_ / 2 - 1) + at(size_ / 2)) / 2;
+        }
+
+    private:
+        [[nodiscard]] std::size_t level_capacity(std::size_t h) const {
+            auto const depth = levels_.size() - 1 - h;
+            return std::max<std::size_t>(2, static_cast<std::size_t>(std::ceil(static_cast<double>(k_) * std::pow(2.0 / 3.0, static_cast<double>(depth)))));
+        }
+
+        [[nodiscard]] std::size_t capacity() const {
+            std::size_t result = 0;
+            for (std::size_t h = 0; h < levels_.size(); ++h)
+                result += level_capacity(h);
+            return result;
+        }
+
+        /// Compacts the lowest full level. An odd item out, the smallest one, stays where it is.
+        void compress() {
+            for (std::size_t h = 0; h < levels_.size(); ++h) {
+                if (levels_[h].size() < level_capacity(h))
+                    continue;
+                if (h + 1 == levels_.size()) {
+                    levels_.emplace_back();
+                    capacity_ = capacity();
+                }
+                auto & level = levels_[h];
+                auto & next = levels_[h + 1];
+                std::sort(level.begin(), level.end());
+                auto const odd = level.size() % 2;
+                for (auto i = odd + (coin_() & 1); i < level.size(); i += 2)
+                    next.push_back(level[i]);
+                held_ -= (level.size() - odd) / 2;
+                level.resize(odd);
+                return;
+            }
+        }
+
+        std::size_t k_;
+        std::vector<std::vector<T>> levels_;
+        std::size_t capacity_;
+        std::uint64_t size_ {0};
+        std::size_t held_ {0};
+        std::minstd_rand coin_;
+    };
+}
@@ -8,9 +8,12 @@
 #include "../external/argparse/argparse.hpp"
 #include "../external/transwarp/transwarp.h"
 #include "reader-bridge-impl.hpp"
+#include <atomic>
+#include <deque>
 #include <filesystem>
 #include <functional>
 #include <numeric>
+#include <random>
 #include "encoding.h"
 
 #include <fcntl.h>
@@ -275,6 +278,72 @@ namespace csvsuite::cli {
         return result;
     }
 
+    /// Returns --memory-limit in bytes, 0 if there is no limit
+    std::size_t memory_limit(auto const & args) {
+        if constexpr (requires { args.memory_limit; }) {
+            std::string const & limit = args.memory_limit;
+            if (limit.empty())
+                return 0;
+            auto const error_message = "Wrong memory limit: " + limit + ". Examples: 1000000, 512K, 64M, 2G.";
+            std::size_t pos = 0;
+            unsigned long long value;
+            try {
+                value = std::stoull(limit, &pos);
+            } catch (std::exception const &) {
+                throw std::runtime_error(error_message);
+            }
+            if (pos == limit.size())
+                return value;
+            if (pos + 1 == limit.size()) {
+                switch (std::toupper(static_cast<unsigned char>(limit[pos]))) {
+                    case 'K': return value << 10;
+                    case 'M': return value << 20;
+                    case 'G': return value << 30;
+                    default: break;
+                }
+            }
+            throw std::runtime_error(error_message);
+        } else
+            return 0;
+    }
+
+    /// Returns --temp-dir, or the system temporary directory
+    std::filesystem::path temp_dir(auto const & args) {
+        if constexpr (requires { args.temp_dir; }) {
+            if (!args.temp_dir.empty())
+                return args.temp_dir;
+        }
+        return std::filesystem::temp_directory_path();
+    }
+
+    /// Temporary files of the utilities working within --memory-limit, removed on the way out
+    class temp_files {
+    public:
+        temp_files(std::filesystem::path dir, std::string prefix, std::string extension)
+            : dir_(std::move(dir)), prefix_(std::move(prefix)), extension_(std::move(extension)) {}
+        temp_files(temp_files const &) = delete;
+        temp_files & operator=(temp_files const &) = delete;
+        ~temp_files() {
+            for (auto const & path : paths_) {
+                std::error_code ec;
+                std::filesystem::remove(path, ec);
+            }
+        }
+        std::filesystem::path const & create() {
+            static std::random_device rd;
+            paths_.push_back(dir_ / (prefix_ + std::to_string(rd()) + '-' + std::to_string(paths_.size()) + extension_));
+            return paths_.back();
+        }
+        [[nodiscard]] auto const & paths() const {
+            return paths_;
+        }
+    private:
+        std::filesystem::path dir_;
+        std::string prefix_;
+        std::string extension_;
+        std::deque<std::filesystem::path> paths_;
+    };
+
     /// The output precision representation class for the csvStat's standard/csv print visitors (except for 'most common values')    
     template <typename T>
     class spec_precision
@@ -893,9 +962,250 @@ namespace csvsuite::cli {
         unsigned cols;
     };
 
+    /// Per-column type lattice: the set of still possible types, narrowed cell by cell in a single pass
+    struct type_lattice {
+        /// Candidate types in order of their precedence (text is the lattice bottom and always possible)
+        enum candidate : unsigned char {
+            bool_c = 1,
+            timedelta_c = 2,
+            datetime_c = 4,
+            date_c = 8,
+            number_c = 16,
+            all_c = bool_c | timedelta_c | datetime_c | date_c | number_c
+        };
+
+        unsigned char candidates {all_c};
+        bool blanks {false};
+        unsigned precision {0};
+
+        /// Narrows the lattice by one cell. Each cell is tested only against the candidates still alive.
+        template <typename Elem, typename Args>
+        void feed(Elem const & e, Args const & args, bool with_precision) {
+            //TODO: for now e.is_null() calling first is obligate. Can we do better?
+            if (e.is_null_or_null_value() && !args.blanks) {
+                blanks = true;
+                return;
+            }
+            if (!candidates)
+                return;
+            if (args.no_inference) {
+                candidates = 0;
+                return;
+            }
+            if ((candidates & bool_c) && !e.is_boolean())
+                candidates &= ~bool_c;
+            if ((candidates & timedelta_c) && !std::get<0>(e.timedelta_tuple()))
+                candidates &= ~timedelta_c;
+            if ((candidates & datetime_c) && !std::get<0>(e.datetime(args.datetime_fmt)))
+                candidates &= ~datetime_c;
+            if ((candidates & date_c) && !std::get<0>(e.date(args.date_fmt)))
+                candidates &= ~date_c;
+            if (candidates & number_c) {
+                if (!e.is_num())
+                    candidates &= ~number_c;
+                else if (with_precision && precision < e.precision())
+                    precision = e.precision();
+            }
+        }
+
+        /// Nothing more can be learned from the remaining cells
+        [[nodiscard]] bool settled(bool with_blanks) const noexcept {
+            return !candidates && (blanks || !with_blanks);
+        }
+
+        /// The most specific type still possible
+        [[nodiscard]] column_type type() const noexcept {
+            if (candidates & bool_c)
+                return column_type::bool_t;
+            if (candidates & timedelta_c)
+                return column_type::timedelta_t;
+            if (candidates & datetime_c)
+                return column_type::datetime_t;
+            if (candidates & date_c)
+                return column_type::date_t;
+            if (candidates & number_c)
+                return column_type::number_t;
+            return column_type::text_t;
+        }
+
+        /// Precision as the former number pass left it: meaningless for types preceding the number one
+        [[nodiscard]] unsigned final_precision() const noexcept {
+            auto const t = type();
+            return t == column_type::number_t || t == column_type::text_t ? precision : 0;
+        }
+
+        /// Appends a lattice inferred over the immediately following rows. Gives exactly the sequential result.
+        void merge(type_lattice const & next) noexcept {
+            if (candidates & number_c)
+                precision = std::max(precision, next.precision);
+            candidates &= next.candidates;
+            blanks = blanks || next.blanks;
+        }
+    };
+
+    /// Infers a lattice over a range of cells of one column, stopping as soon as it is settled
+    template <typename It, typename Args>
+    auto infer_column(It first, It last, Args const & args, bool with_precision, bool with_blanks) {
+        type_lattice lattice;
+        for (; first != last && !lattice.settled(with_blanks); ++first)
+            lattice.feed(*first, args, with_precision);
+        return lattice;
+    }
+
+    /// Minimum number of rows worth a separate inference task
+    constexpr std::size_t min_inference_chunk = 16384;
+
+    /// Returns the number of leading rows types are inferred from (0 means all the rows)
+    auto infer_rows_limit(auto const & args) -> std::size_t {
+        if constexpr (requires { args.infer_rows; })
+            return args.infer_rows;
+        else
+            return 0;
+    }
+
+    /// Infers lattices of all the columns of a column-major table over the [first_row, last_row) range,
+    /// in parallel over columns and row chunks, so that narrow but tall tables also load all the cores.
+    /// A bool test leaves its verdict cached in a cell, and a later number test accepts such a cell, so the sequential
+    /// pass must be reproduced: a chunk only learns where its leading bool values end, on copies of the cells, and
+    /// that head is fed once the preceding chunks tell whether the bool candidate is still alive.
+    template <typename Table, typename Args>
+    auto infer_table_rows(Table & table, Args const & args, bool with_precision, bool with_blanks
+                        , std::size_t first_row, std::size_t last_row, std::vector<unsigned char> const & seeds) -> std::vector<type_lattice> {
+        auto const columns = table.rows();
+        if (!columns)
+            return {};
+        auto const rows = last_row - first_row;
+        auto const concurrency = std::max(1u, std::thread::hardware_concurrency());
+        auto const chunks = std::clamp<std::size_t>(rows / min_inference_chunk, 1, concurrency);
+        auto const chunk_rows = (rows + chunks - 1) / chunks;
+        auto const chunk_first = [&](std::size_t k) { return first_row + std::min(rows, k * chunk_rows); };
+
+        std::vector<type_lattice> partial(columns * chunks);
+        // the end of the head of every chunk, the rows fed in the merge
+        std::vector<std::size_t> heads(partial.size());
+        for (auto t = 0u; t < partial.size(); ++t) {
+            partial[t].candidates = seeds[t / chunks];
+            heads[t] = chunk_first(t % chunks);
+        }
+        // the lowest chunk of a column which has already been settled: later chunks can not change the result
+        std::vector<std::atomic<std::size_t>> settled_chunk(columns);
+        for (auto & e : settled_chunk)
+            e.store(chunks, std::memory_order_relaxed);
+
+        std::vector<std::size_t> task_numbers (partial.size());
+        std::iota(task_numbers.begin(), task_numbers.end(), 0);
+
+        transwarp::parallel exec(concurrency);
+        auto task = transwarp::for_each(exec, task_numbers.cbegin(), task_numbers.cend(), [&](auto t) {
+            auto const c = t / chunks;
+            auto const k = t % chunks;
+            auto const first = table[c].cbegin() + static_cast<std::ptrdiff_t>(chunk_first(k));
+            auto const last = table[c].cbegin() + static_cast<std::ptrdiff_t>(chunk_first(k + 1));
+
+            auto & lattice = partial[t];
+            std::size_t fed = 0;
+            auto abandoned = [&] {
+                return !(++fed % 1024) && settled_chunk[c].load(std::memory_order_relaxed) < k;
+            };
+            auto it = first;
+            if (k && (lattice.candidates & type_lattice::bool_c) && !args.no_inference) {
+                // the head runs up to and including the first non-null value that is not a bool
+                for (bool head = true; head && it != last; ++it) {
+                    if (abandoned())
+                        return;
+                    auto probe = *it;
+                    head = (probe.is_null_or_null_value() && !args.blanks) || probe.is_boolean();
+                }
+                heads[t] = chunk_first(k) + static_cast<std::size_t>(it - first);
+                // the rest is fed past the bool candidate, and a chunk of bool values only is no constraint at all
+                lattice.candidates = static_cast<unsigned char>(it == last ? type_lattice::all_c : lattice.candidates & ~type_lattice::bool_c);
+            }
+            for (; it != last && !lattice.settled(with_blanks); ++it) {
+                if (abandoned())
+                    return;
+                lattice.feed(*it, args, with_precision);
+            }
+            if (lattice.settled(with_blanks)) {
+                auto prev = settled_chunk[c].load(std::memory_order_relaxed);
+                while (k < prev && !settled_chunk[c].compare_exchange_weak(prev, k, std::memory_order_relaxed));
+            }
+        });
+        task->wait();
+
+        std::vector<type_lattice> result(columns);
+        std::vector<std::size_t> column_numbers (columns);
+        std::iota(column_numbers.begin(), column_numbers.end(), 0);
+        auto merge = transwarp::for_each(exec, column_numbers.cbegin(), column_numbers.cend(), [&](auto c) {
+            result[c] = partial[c * chunks];
+            for (auto k = 1u; k < chunks; ++k) {
+                auto const t = c * chunks + k;
+                for (auto r = chunk_first(k); r < heads[t] && !result[c].settled(with_blanks); ++r)
+                    result[c].feed(table[c][r], args, with_precision);
+                result[c].merge(partial[t]);
+            }
+        });
+        merge->wait();
+        return result;
+    }
+
+    /// Infers lattices of all the columns over consecutive batches of rows, so that the whole table does not have
+    /// to be kept at once. The result is the one of inferring all the rows in one go.
+    /// With --infer-rows N the first N rows are inferred on their own, and the rest of the rows are tested against the
+    /// candidates the sample left alive only. A contradicting cell drops a candidate, so the column falls back to the
+    /// next type still possible, text last.
+    class batched_inference {
+    public:
+        batched_inference(std::size_t columns, std::size_t limit) : result_(columns), limit_(limit) {}
+
+        /// Feeds the first rows of a column-major table as the next batch
+        template <typename Table, typename Args>
+        void feed(Table & table, std::size_t rows, Args const & args, bool with_precision, bool with_blanks) {
+            std::size_t first = 0;
+            if (limit_ && seen_ < limit_) {
+                first = std::min(rows, limit_ - seen_);
+                append(infer_table_rows(table, args, with_precision, with_blanks, 0, first, seeds()));
+                seen_ += first;
+            }
+            if (first < rows) {
+                append(infer_table_rows(table, args, with_precision, with_blanks, first, rows, seeds()));
+                seen_ += rows - first;
+            }
+        }
+
+        [[nodiscard]] std::vector<type_lattice> const & result() const noexcept {
+            return result_;
+        }
+
+    private:
+        /// Dead candidates need no testing in later rows
+        [[nodiscard]] std::vector<unsigned char> seeds() const {
+            std::vector<unsigned char> seeds(result_.size());
+            std::transform(result_.begin(), result_.end(), seeds.begin(), [](auto const & e) { return e.candidates; });
+            return seeds;
+        }
+
+        void append(std::vector<type_lattice> const & next) {
+            for (auto c = 0u; c < result_.size(); ++c)
+                result_[c].merge(next[c]);
+        }
+
+        std::vector<type_lattice> result_;
+        std::size_t limit_;
+        std::size_t seen_ {0};
+    };
+
+    /// Infers lattices of all the columns of a column-major table
+    template <typename Table, typename Args>
+    auto infer_table(Table & table, Args const & args, bool with_precision, bool with_blanks) -> std::vector<type_lattice> {
+        auto const columns = table.rows();
+        batched_inference inference(columns, infer_rows_limit(args));
+        inference.feed(table, columns ? table.cols() : 0, args, with_precision, with_blanks);
+        return inference.result();
+    }
+
     /// Detects types, blanks and precisions for every column
     template <typename Reader, typename Args>
-    auto typify(Reader & reader, Args const & args, typify_option option) -> typify_result {
+    auto typify(Reader & reader, Args const & args, typify_option option, std::size_t batch_rows = 0) -> typify_result {
 
         update_null_values(args.null_value);
 
@@ -918,7 +1228,25 @@ namespace csvsuite::cli {
             check_max_size(header, size_checker);
         }
 
-        fixed_array_2d_replacement<typename Reader::template typed_span<csv_co::unquoted>> table(header.size(), reader.rows());
+        imbue_numeric_locale(reader, args);
+        [&option] {
+            using unquoted_elem_type = typename Reader::template typed_span<csv_co::unquoted>;
+            unquoted_elem_type::no_maxprecision(option != typify_option::typify_with_precisions);
+
+            using quoted_elem_type = typename Reader::template typed_span<csv_co::quoted>;
+            unquoted_elem_type::no_maxprecision(option != typify_option::typify_with_precisions);
+        }();
+
+        setup_date_parser_backend(reader, args);
+        setup_leading_zeroes_processing(reader, args);
+
+        auto const with_precision = option == typify_option::typify_with_precisions;
+        auto const with_blanks = option != typify_option::typify_without_precisions_and_blanks;
+
+        // With batch_rows given the table holds a batch of rows at a time, not the whole body
+        auto const table_rows = batch_rows ? std::min<std::size_t>(batch_rows, reader.rows()) : reader.rows();
+        fixed_array_2d_replacement<typename Reader::template typed_span<csv_co::unquoted>> table(header.size(), table_rows);
+        batched_inference inference(header.size(), infer_rows_limit(args));
 
         auto c_row{0u};
         auto c_col{0u};
@@ -939,113 +1267,28 @@ namespace csvsuite::cli {
             for (auto & elem : rowspan)
                 table[c_col++][c_row] = elem;
 
-            c_row++;
             c_col = 0;
+            if (++c_row == table_rows && batch_rows) {
+                inference.feed(table, c_row, args, with_precision, with_blanks);
+                c_row = 0;
+            }
         });
+        if (!batch_rows)
+            inference.feed(table, table_rows, args, with_precision, with_blanks);
+        else if (c_row)
+            inference.feed(table, c_row, args, with_precision, with_blanks);
 
         std::vector<column_type> types (table.rows(), column_type::unknown_t);
-
-        std::vector<std::size_t> column_numbers (types.size());
-        std::iota(column_numbers.begin(), column_numbers.end(), 0);
-    
-        transwarp::parallel exec(std::thread::hardware_concurrency());
-
         std::vector<unsigned char> blanks (types.size(), 0);
         std::vector<unsigned> precisions (types.size(), 0);
 
-        imbue_numeric_locale(reader, args);
-        [&option] {
-            using unquoted_elem_type = typename Reader::template typed_span<csv_co::unquoted>;
-            unquoted_elem_type::no_maxprecision(option != typify_option::typify_with_precisions);
-
-            using quoted_elem_type = typename Reader::template typed_span<csv_co::quoted>;
-            unquoted_elem_type::no_maxprecision(option != typify_option::typify_with_precisions);
-        }();
-
-        setup_date_parser_backend(reader, args);
-        setup_leading_zeroes_processing(reader, args);
-
-        //TODO: for now e.is_null() calling first is obligate. Can we do better?
-
-        std::function<void(unsigned, bool)> setup_blanks;
-
-        if (option != typify_option::typify_without_precisions_and_blanks)
-            setup_blanks = [&](unsigned c, bool n) {
-                if (!blanks[c] && n)
-                    blanks[c] = 1;
-            };
-        else
-            setup_blanks = [](unsigned, bool) {};
-
-        auto task = transwarp::for_each(exec, column_numbers.cbegin(), column_numbers.cend(), [&](auto c) {
-            if (std::all_of(table[c].begin(), table[c].end(), [&args, &c, &setup_blanks](auto & e)  {
-                auto const n = e.is_null_or_null_value() && !args.blanks;
-                setup_blanks(c, n);
-                return n || (!args.no_inference && e.is_boolean());
-            })) {
-                types[c] = column_type::bool_t;
-                return;
-            }
-            if (std::all_of(table[c].begin(), table[c].end(), [&args, &c, &setup_blanks](auto &e) {
-                auto const n = e.is_null_or_null_value() && !args.blanks;
-                setup_blanks(c, n);
-                return n || (!args.no_inference && std::get<0>(e.timedelta_tuple()));
-            })) {
-                types[c] = column_type::timedelta_t;
-                return;
-            }
-            if (std::all_of(table[c].begin(), table[c].end(), [&args, &c, &setup_blanks](auto & e) {
-                auto const n = e.is_null_or_null_value() && !args.blanks;
-                setup_blanks(c, n);
-                return n || (!args.no_inference && std::get<0>(e.datetime(args.datetime_fmt)));
-            })) {
-                types[c] = column_type::datetime_t;
-                return;
-            }
-            if (std::all_of(table[c].begin(), table[c].end(), [&args, &c, &setup_blanks](auto &e) {
-                auto const n = e.is_null_or_null_value() && !args.blanks;
-                setup_blanks(c, n);
-                return n || (!args.no_inference && std::get<0>(e.date(args.date_fmt)));
-            })) {
-                types[c] = column_type::date_t;
-                return;
-            }
-            if (option == typify_option::typify_with_precisions) {
-                if (std::all_of(table[c].begin(), table[c].end(), [&args, &c, &precisions, &setup_blanks](auto & e) {
-                    auto const n = e.is_null_or_null_value() && !args.blanks;
-                    setup_blanks(c, n);
-                    auto const result = n || (!args.no_inference && e.is_num());
-                    if (result and !n) {
-                        if (precisions[c] < e.precision())
-                            precisions[c] = e.precision();
-                    }
-                    return result;
-                })) {
-                    types[c] = column_type::number_t;
-                    return;
-                }
-            } else {
-                if (std::all_of(table[c].begin(), table[c].end(), [&args, &c, &setup_blanks](auto & e) {
-                    auto const n = e.is_null_or_null_value() && !args.blanks;
-                    setup_blanks(c, n);
-                    return n || (!args.no_inference && e.is_num());
-                })) {
-                    types[c] = column_type::number_t;
-                    return;
-                }
-            }
-            // Text type: check ALL rows for an absent.
-            if (std::all_of(table[c].begin(), table[c].end(), [&](auto &e) {
-                auto const n = e.is_null_or_null_value() && !args.blanks;
-                setup_blanks(c, n);
-                return true;
-            })) {
-                types[c] = column_type::text_t;
-                return;
-            }
-        });
-
-        task->wait();
+        auto const & lattices = inference.result();
+        for (auto c = 0u; c < types.size(); ++c) {
+            types[c] = lattices[c].type();
+            if (with_blanks)
+                blanks[c] = lattices[c].blanks;
+            precisions[c] = lattices[c].final_precision();
+        }
 
         for (auto & elem : types) {
             assert(elem != column_type::unknown_t);
@@ -1206,7 +1449,7 @@ namespace csvsuite::cli {
     /// Common template function to compose custom boolean value representation
     template <typename T, typename Q=void>
     std::string compose_bool_DRY (T const & elem) {
-        static bool_stringstream<Q> ss;
+        thread_local bool_stringstream<Q> ss;
         ss.rdbuf()->str("");
         ss << std::boolalpha << (elem.is_boolean(), static_cast<bool>(elem.unsafe()));
         return ss.str();
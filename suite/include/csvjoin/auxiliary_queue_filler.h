@@ -28,8 +28,12 @@ try {
         auto const q_header = header_to_strings<unquoted>(header);
 
         headers.push_back(q_header);
-        if (!join_column_names.empty())
-            c_ids.push_back(match_column_identifier(q_header, join_column_names[idx++].c_str(), get_column_offset(args)));
+        if (!join_column_names.empty()) {
+            std::vector<unsigned> key;
+            for (auto const & name : parse_key_column_names(join_column_names[idx++]))
+                key.push_back(match_column_identifier(q_header, name.c_str(), get_column_offset(args)));
+            c_ids.push_back(std::move(key));
+        }
     });
 } catch (ColumnIdentifierError const& e) {
     std::cerr << e.what() << std::endl;
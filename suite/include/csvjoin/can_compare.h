@@ -1,19 +1,29 @@
 //------------------- This is just a code to inline it "in place" by the C preprocessor directive #include. See csvJoin.cpp --------------
 
+/// Whether the keys of the two tables compare, column by column. Key columns of different types having blanks are
+/// both compared as text.
 auto can_compare = [&](auto & types0, auto & types1, auto & blanks0, auto & blanks1) {
-    if (types0[c_ids[0]] == types1[c_ids[1]] or args.no_inference) {
-        if (args.no_inference) {
-            assert(types0[c_ids[0]] == column_type::text_t);
-            assert(types1[c_ids[1]] == column_type::text_t);
+    auto const & key0 = c_ids[0];
+    auto const & key1 = c_ids[1];
+    assert(key0.size() == key1.size());
+    for (std::size_t i = 0; i < key0.size(); ++i) {
+        if (types0[key0[i]] == types1[key1[i]] or args.no_inference) {
+            if (args.no_inference) {
+                assert(types0[key0[i]] == column_type::text_t);
+                assert(types1[key1[i]] == column_type::text_t);
+            }
+            continue;
         }
-        return true;
+        if (!blanks0[key0[i]] or !blanks1[key1[i]])
+            return false;
     }
-    if (blanks0[c_ids[0]] and blanks1[c_ids[1]]) {
-        types0[c_ids[0]] = column_type::text_t;
-        types1[c_ids[1]] = column_type::text_t;
-        return true;
+    for (std::size_t i = 0; i < key0.size(); ++i) {
+        if (types0[key0[i]] != types1[key1[i]]) {
+            types0[key0[i]] = column_type::text_t;
+            types1[key1[i]] = column_type::text_t;
+        }
     }
-    return false;
+    return true;
 };
 
 //------------------- This is just a code to inline it "in place" by the C preprocessor directive #include. See csvJoin.cpp --------------
@@ -1,6 +1,14 @@
 //------------------- This is just a code to inline it "in place" by the C preprocessor directive #include. See csvJoin.cpp --------------
 
-auto concat_headers = [&headers](unsigned excl_v_idx = static_cast<unsigned>(-1)) {
+/// Erases the excluded columns of the second table from the columns the tables have together
+auto erase_columns = [](auto & columns, std::size_t second_table_offset, std::vector<unsigned> excluded) {
+    std::sort(excluded.begin(), excluded.end(), std::greater<>{});
+    excluded.erase(std::unique(excluded.begin(), excluded.end()), excluded.end());
+    for (auto c : excluded)
+        columns.erase(columns.begin() + second_table_offset + c);
+};
+
+auto concat_headers = [&headers, &erase_columns](std::vector<unsigned> const & excluded = {}) {
     std::string subst;
     unsigned const h0_size = headers[0].size();
     std::replace_copy_if(headers[1].begin(), headers[1].end(), std::back_inserter(headers[0]),
@@ -32,11 +40,10 @@ auto concat_headers = [&headers](unsigned excl_v_idx = static_cast<unsigned>(-1)
                 mangled_number++;
             }
         }, subst);
-    if (excl_v_idx != static_cast<unsigned>(-1))
-        headers[0].erase(headers[0].begin() + h0_size + excl_v_idx);
+    erase_columns(headers[0], h0_size, excluded);
 };
 
-auto concat_ts_n_blanks = [&ts_n_blanks](unsigned excl_idx = static_cast<unsigned>(-1)) {
+auto concat_ts_n_blanks = [&ts_n_blanks, &erase_columns](std::vector<unsigned> const & excluded = {}) {
     unsigned const size_0 = std::get<0>(ts_n_blanks[0]).size();
     auto & types_0 = std::get<0>(ts_n_blanks[0]);
     auto const & types_1 = std::get<0>(ts_n_blanks[1]);
@@ -46,10 +53,8 @@ auto concat_ts_n_blanks = [&ts_n_blanks](unsigned excl_idx = static_cast<unsigne
     types_0.insert(types_0.end(), types_1.begin(), types_1.end());
     blanks_0.insert(blanks_0.end(), blanks_1.begin(), blanks_1.end());
 
-    if (excl_idx != static_cast<unsigned>(-1)) {
-        types_0.erase(types_0.begin() + size_0 + excl_idx);
-        blanks_0.erase(blanks_0.begin() + size_0 + excl_idx);
-    }
+    erase_columns(types_0, size_0, excluded);
+    erase_columns(blanks_0, size_0, excluded);
 };
 
 enum class exclude_c_column {
@@ -61,16 +66,22 @@ enum class union_join {
     no
 }; 
 
-auto cycle_cleanup = [&](exclude_c_column is_c_excluded = exclude_c_column::yes, union_join is_union_join = union_join::no) {
-    deq.pop_front();
-    deq.pop_front();
-    concat_headers(is_c_excluded == exclude_c_column::yes ? c_ids[1] : static_cast<unsigned>(-1));
+/// Merges the headers, types and blanks of the two tables of a join stage into those of its result
+auto merge_stage = [&](exclude_c_column is_c_excluded = exclude_c_column::yes, union_join is_union_join = union_join::no) {
+    auto const excluded = is_c_excluded == exclude_c_column::yes ? c_ids[1] : std::vector<unsigned>{};
+    concat_headers(excluded);
     headers.erase(headers.begin() + 1);
-    concat_ts_n_blanks(is_c_excluded == exclude_c_column::yes ? c_ids[1] : static_cast<unsigned>(-1));
+    concat_ts_n_blanks(excluded);
 
     if (is_union_join == union_join::no)
         c_ids.erase(c_ids.begin() + 1);
     ts_n_blanks.erase(ts_n_blanks.begin() + 1);
 };
 
+auto cycle_cleanup = [&](exclude_c_column is_c_excluded = exclude_c_column::yes, union_join is_union_join = union_join::no) {
+    deq.pop_front();
+    deq.pop_front();
+    merge_stage(is_c_excluded, is_union_join);
+};
+
 //------------------- This is just a code to inline it "in place" by the C preprocessor directive #include. See csvJoin.cpp --------------
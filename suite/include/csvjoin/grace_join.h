@@ -0,0 +1,262 @@
+//------------------- This is just a code to inline it "in place" by the C preprocessor directive #include. See csvJoin.cpp --------------
+
+/// Partition files and results of the joins within --memory-limit. The last result is printed from its file.
+temp_files grace_files(temp_dir(args), "csvjoin-", ".csv");
+
+/// What a source takes in memory, as a table and as a key index, estimated
+auto grace_cost = [](std::size_t rows, std::size_t cols) {
+    return rows * (cols * sizeof(typename reader_type::template typed_span<csv_co::quoted>) + 4 * sizeof(std::size_t));
+};
+
+/// All the sources fit within --memory-limit as they are estimated, so the joins are made in memory as without the limit.
+/// The joins in memory keep every source at once, whichever stage the largest one is joined at.
+auto fits_in_memory = [&deq, &ts_n_blanks, &args, &grace_cost](std::size_t limit) {
+    if (deq.size() < 2)
+        return true;
+    auto const preamble_rows = args.skip_lines + (args.no_header ? 0 : 1);
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < deq.size(); ++i) {
+        auto & source = std::get<0>(deq[i]);
+        total += grace_cost(source.rows() > preamble_rows ? source.rows() - preamble_rows : 0, std::get<0>(ts_n_blanks[i]).size());
+    }
+    return total <= limit;
+};
+
+auto grace_join = [&deq, &headers, &ts_n_blanks, &c_ids, &args, &cycle_cleanup, &can_compare, &align_blanks, &grace_files, &grace_cost](std::size_t limit) {
+    assert(!c_ids.empty());
+    using elem_type = typename reader_type::template typed_span<csv_co::quoted>;
+    using hash_type = compromise_hash<reader_type, args_type>;
+    using table_type = typename reader_fake<reader_type>::table;
+    bool const keep_left = args.left_join || args.right_join || args.outer_join;
+    bool const outer = args.outer_join;
+
+    // Skipped lines and the header, for a file to be read as the sources are
+    auto preamble = [&](std::vector<std::string> const & header) {
+        std::string line;
+        for (auto const & name : header)
+            line += (line.empty() ? "" : ",") + csv_quoted(name);
+        line += '\n';
+        std::string result;
+        for (unsigned i = 0; i < args.skip_lines; ++i)
+            result += line;
+        return args.no_header ? result : result + line;
+    };
+
+    // Calls f for every body row of a source
+    auto for_each_row = [&](auto & source, auto && f) {
+        if constexpr(std::is_same_v<std::decay_t<decltype(source)>, reader_type>) {
+            source.skip_rows(0);
+            skip_lines(source, args);
+            obtain_header_and_<skip_header>(source, args);
+            source.run_rows([&](auto & span) { f(span); });
+        } else {
+            for (auto const & row : source.operator table_type &())
+                f(row);
+        }
+    };
+
+    while (deq.size() > 1) {
+#if !defined(__clang__) || __clang_major__ >= 16
+        auto & [types0, blanks0] = ts_n_blanks[0];
+        auto & [types1, blanks1] = ts_n_blanks[1];
+#else
+        auto & types0 = std::get<0>(ts_n_blanks[0]);
+        auto & types1 = std::get<0>(ts_n_blanks[1]);
+        auto & blanks0 = std::get<1>(ts_n_blanks[0]);
+        auto & blanks1 = std::get<1>(ts_n_blanks[1]);
+#endif
+        bool const comparable = can_compare(types0, types1, blanks0, blanks1);
+        join_shape const shape{types0.size(), types1.size(), outer ? std::vector<unsigned>{} : c_ids[1]};
+        std::vector<hash_fun<elem_type>> hashes;
+        for (auto column : c_ids[1])
+            hashes.push_back(obtain_hash_functionality<elem_type>(column, align_blanks(), args));
+        bool recalculate_types_blanks = false;
+
+        auto result_header = headers[0];
+        for (unsigned c = 0; c < headers[1].size(); ++c)
+            if (!is_excluded(shape.excluded, c))
+                result_header.push_back(headers[1][c]);
+        auto const & result_path = grace_files.create();
+        std::ofstream result(result_path, std::ios::binary);
+        result << preamble(result_header);
+
+        // Writes the rows of a source with empty cells in place of the other one
+        auto write_distinct = [&](auto & source, bool left_side) {
+            std::string const others(left_side ? result_header.size() - shape.left_cols : shape.left_cols, ',');
+            for_each_row(source, [&](auto const & row) {
+                if (!left_side)
+                    result << others;
+                bool first = true;
+                for (auto const & cell : row) {
+                    if (!first)
+                        result << ',';
+                    first = false;
+                    result << std::string(cell);
+                }
+                if (left_side)
+                    result << others;
+                result << '\n';
+            });
+            recalculate_types_blanks = recalculate_types_blanks || !left_side;
+        };
+
+        // Joins a left table with the key index of a right source, either may be missing for having no rows
+        auto join_tables = [&](auto * left, std::size_t left_rows, hash_type const * right) {
+            std::vector<joined_row> rows;
+            auto write = [&](auto const & l, auto const & r) {
+                for (auto const & row : rows) {
+                    bool first = true;
+                    for_each_joined_cell(l, r, shape, row, [&](auto const & cell) {
+                        if (!first)
+                            result << ',';
+                        first = false;
+                        result << std::string(cell);
+                    });
+                    result << '\n';
+                }
+            };
+            if (left && right) {
+                auto const & right_rows = right->hash().rows();
+                std::vector<unsigned char> matched(outer ? right_rows.rows() : 0);
+                rows = probe(*left, left_rows, c_ids[0], right->hash(), keep_left, outer ? &matched : nullptr);
+                for (std::size_t r = 0; r < matched.size(); ++r) {
+                    if (!matched[r]) {
+                        rows.push_back({no_row, r});
+                        recalculate_types_blanks = true;
+                    }
+                }
+                write(*left, right_rows);
+            } else if (left) {
+                if (keep_left)
+                    for (std::size_t r = 0; r < left_rows; ++r)
+                        rows.push_back({r, no_row});
+                write(*left, *left);
+            } else if (right && outer) {
+                auto const & right_rows = right->hash().rows();
+                for (std::size_t r = 0; r < right_rows.rows(); ++r)
+                    rows.push_back({no_row, r});
+                recalculate_types_blanks = recalculate_types_blanks || !rows.empty();
+                write(right_rows, right_rows);
+            }
+        };
+
+        // Joins two sources in memory
+        auto join_in_memory = [&](auto & left, reader_type & right) {
+            std::unique_ptr<hash_type> chash;
+            try {
+                chash = std::make_unique<hash_type>(right, args, align_blanks(), c_ids[1]);
+            } catch (no_body_exception const &) {}
+            if constexpr(std::is_same_v<std::decay_t<decltype(left)>, reader_type>) {
+                std::unique_ptr<compromise_table_MxN<reader_type, args_type>> table;
+                try {
+                    table = std::make_unique<compromise_table_MxN<reader_type, args_type>>(left, args);
+                } catch (no_body_exception const &) {}
+                join_tables(table.get(), table ? table->rows() : 0, chash.get());
+            } else {
+                auto & table = left.operator table_type &();
+                join_tables(table.empty() ? nullptr : std::addressof(table), table.size(), chash.get());
+            }
+        };
+
+        // Deals the rows of a source out to partition files by the bits of their key hashes
+        auto deal_out = [&](auto & source, std::vector<unsigned> const & columns, std::vector<std::string> const & header, unsigned shift, unsigned bits) {
+            std::vector<std::filesystem::path> paths;
+            std::vector<std::ofstream> outs;
+            std::vector<std::size_t> rows(std::size_t{1} << bits);
+            auto const head = preamble(header);
+            for (std::size_t p = 0; p < rows.size(); ++p) {
+                paths.push_back(grace_files.create());
+                outs.emplace_back(paths.back(), std::ios::binary);
+                outs.back() << head;
+            }
+            for_each_row(source, [&](auto const & row) {
+                std::size_t h = 0;
+                for (std::size_t i = 0; i < columns.size(); ++i) {
+                    elem_type const key{row[columns[i]]};
+                    std::size_t cell_hash;
+                    std::visit([&](auto & f) { cell_hash = f(key); }, hashes[i]);
+                    h = i ? hash_combine(h, cell_hash) : cell_hash;
+                }
+                auto const p = grace_partition(spread_hash(h), shift, bits);
+                write_csv_row(outs[p], row);
+                ++rows[p];
+            });
+            for (std::size_t p = 0; p < outs.size(); ++p)
+                if (!outs[p].flush())
+                    throw std::runtime_error("Can not write the temporary file " + paths[p].string());
+            return std::tuple{paths, rows};
+        };
+
+        // Splits a pair of sources too large to be joined in memory into pairs of partitions, and joins them one by
+        // one, splitting a skewed pair further by the next hash bits
+        auto grace = [&](auto & self, auto & left, std::size_t left_rows, reader_type & right, std::size_t right_rows, unsigned shift) -> void {
+            auto const total = grace_cost(left_rows, shape.left_cols) + grace_cost(right_rows, shape.right_cols);
+            auto const bits = std::clamp<unsigned>(static_cast<unsigned>(std::bit_width(2 * (total / limit))), 1, grace_max_bits);
+            if (total <= limit || shift + bits > grace_last_bit) {
+                join_in_memory(left, right);
+                return;
+            }
+            auto const [left_paths, left_counts] = deal_out(left, c_ids[0], headers[0], shift, bits);
+            auto const [right_paths, right_counts] = deal_out(right, c_ids[1], headers[1], shift, bits);
+            for (std::size_t p = 0; p < left_paths.size(); ++p) {
+                if (left_counts[p] && right_counts[p]) {
+                    reader_type left_part(left_paths[p]);
+                    reader_type right_part(right_paths[p]);
+                    self(self, left_part, left_counts[p], right_part, right_counts[p], shift + bits);
+                } else if (left_counts[p] && keep_left) {
+                    reader_type left_part(left_paths[p]);
+                    write_distinct(left_part, true);
+                } else if (right_counts[p] && outer) {
+                    reader_type right_part(right_paths[p]);
+                    write_distinct(right_part, false);
+                }
+                std::error_code ec;
+                std::filesystem::remove(left_paths[p], ec);
+                std::filesystem::remove(right_paths[p], ec);
+            }
+        };
+
+        auto & right_reader = std::get<0>(deq[1]);
+        auto const preamble_rows = args.skip_lines + (args.no_header ? 0 : 1);
+        auto const body_rows = [&](reader_type & r) {
+            return r.rows() > preamble_rows ? r.rows() - preamble_rows : 0;
+        };
+        try {
+            std::visit([&](auto & arg) {
+                if (!comparable) {
+                    if (keep_left)
+                        write_distinct(arg, true);
+                    if (outer)
+                        write_distinct(right_reader, false);
+                    return;
+                }
+                if constexpr(std::is_same_v<std::decay_t<decltype(arg)>, reader_type>)
+                    grace(grace, arg, body_rows(arg), right_reader, body_rows(right_reader), grace_first_bit);
+                else
+                    grace(grace, arg, arg.operator table_type &().size(), right_reader, body_rows(right_reader), grace_first_bit);
+            }, deq.front());
+        } catch (typename reader_type::implementation_exception const &) {}
+
+        if (!result.flush())
+            throw std::runtime_error("Can not write the temporary file " + result_path.string());
+        result.close();
+
+        cycle_cleanup(outer ? exclude_c_column::no : exclude_c_column::yes);
+
+        // the joined rows are read back by the next join stage, or printed
+        reader_type result_reader(result_path);
+        bool const recalculate = args.honest_outer_join ? recalculate_types_blanks : (recalculate_types_blanks && !deq.empty());
+        if (outer && recalculate) {
+            skip_lines(result_reader, args);
+            try {
+                ts_n_blanks[0] = std::get<1>(::csvsuite::cli::typify(result_reader, args, typify_option::typify_without_precisions));
+            } catch (no_body_exception const &) {}
+        }
+        result_reader.skip_rows(0);
+        skip_lines(result_reader, args);
+        obtain_header_and_<skip_header>(result_reader, args);
+        deq.push_front(std::move(result_reader));
+    }
+};
+
+//------------------- This is just a code to inline it "in place" by the C preprocessor directive #include. See csvJoin.cpp --------------
@@ -0,0 +1,140 @@
+//------------------- This is just a code to inline it "in place" by the C preprocessor directive #include. See csvJoin.cpp --------------
+
+/// Performs the inner, left, right and outer joins. A join stage result is kept as tuples of row numbers of the files
+/// joined so far, and the next stage probes the key index of its file with the key cells of the first file in the
+/// tuples: no result is turned into strings to be typified again. The last result is printed by late_output.
+auto hash_join = [&deq, &ts_n_blanks, &c_ids, &args, &merge_stage, &can_compare, &align_blanks_impl, &align_blanks, &late_output] {
+    assert(!c_ids.empty());
+    using elem_type = typename reader_type::template typed_span<csv_co::quoted>;
+    using rows_type = cell_arena_MxN<elem_type>;
+    using hash_type = compromise_hash<reader_type, args_type>;
+    bool const keep_left = args.left_join || args.right_join || args.outer_join;
+    bool const outer = args.outer_join;
+    auto const files = deq.size();
+    auto const key_columns = c_ids[0];
+    if (files < 2)
+        return;
+
+    // Makes the rows or the key index of a file, nothing for a file having no rows
+    auto unless_empty = [](auto && make) -> decltype(make()) {
+        try {
+            return make();
+        }
+        catch (typename reader_type::implementation_exception const &) {}
+        catch (no_body_exception const &) {}
+        return {};
+    };
+
+    std::vector<joined_table<rows_type>> tables;
+    row_tuples tuples;
+    auto & first = std::get<0>(deq[0]);
+    tables.push_back({nullptr, nullptr, std::get<0>(ts_n_blanks[0]).size(), {}});
+
+    // An inner join of two files is symmetric: the smaller file is hashed, and the larger one probes it
+    auto smaller_first_hashed = [&] {
+        auto & second = std::get<0>(deq[1]);
+        if (keep_left || files != 2 || first.rows() >= second.rows())
+            return false;
+        if (!can_compare(std::get<0>(ts_n_blanks[0]), std::get<0>(ts_n_blanks[1]), std::get<1>(ts_n_blanks[0]), std::get<1>(ts_n_blanks[1])))
+            return false;
+        tables.push_back({nullptr, nullptr, std::get<0>(ts_n_blanks[1]).size(), c_ids[1]});
+        tuples = row_tuples(2);
+        auto lhash = unless_empty([&] { return std::make_shared<hash_type>(first, args, align_blanks_impl(ts_n_blanks[0], c_ids[0]), c_ids[0]); });
+        auto other = unless_empty([&] { return std::make_shared<rows_type>(second, args); });
+        if (lhash && other) {
+            auto const & left_rows = lhash->hash().rows();
+            tables[0].owner = lhash;
+            tables[0].rows = &left_rows;
+            tables[1].owner = other;
+            tables[1].rows = other.get();
+            auto const rows = probe(*other, other->rows(), c_ids[1], lhash->hash(), false);
+            tuples = row_tuples::of_rows(left_rows.rows()).extended(swap_sides(rows, left_rows.rows()));
+        }
+        merge_stage();
+        return true;
+    };
+
+    if (!smaller_first_hashed()) {
+        if (auto first_rows = unless_empty([&] { return std::make_shared<rows_type>(first, args); })) {
+            tables[0].owner = first_rows;
+            tables[0].rows = first_rows.get();
+            tuples = row_tuples::of_rows(first_rows->rows());
+        } else
+            tuples = row_tuples(1);
+    }
+
+    // the key of a tuple is the key of its row of the first file, empty cells for having none
+    static std::string const empty;
+    rows_type empty_row(tables[0].cols);
+    empty_row.append(std::vector<elem_type>(tables[0].cols, elem_type{empty}));
+    auto key_of = [&](std::size_t t) {
+        auto const r = tuples[t][0];
+        return row_key<elem_type, typename rows_type::const_row_view>(r == no_row ? std::as_const(empty_row)[0] : (*tables[0].rows)[r], key_columns);
+    };
+
+    for (auto file = tables.size(); file < files; ++file) {
+        auto & types0 = std::get<0>(ts_n_blanks[0]);
+        auto & types1 = std::get<0>(ts_n_blanks[1]);
+        auto & blanks0 = std::get<1>(ts_n_blanks[0]);
+        auto & blanks1 = std::get<1>(ts_n_blanks[1]);
+        auto & reader = std::get<0>(deq[file]);
+        bool const comparable = can_compare(types0, types1, blanks0, blanks1);
+        auto const left_cols = types0.size();
+        joined_table<rows_type> table{nullptr, nullptr, types1.size(), outer ? std::vector<unsigned>{} : c_ids[1]};
+
+        // Tuples with their matches (or none), then the rows of the file no tuple matches
+        std::vector<joined_row> rows;
+        std::shared_ptr<hash_type> chash;
+        if (comparable)
+            chash = unless_empty([&] { return std::make_shared<hash_type>(reader, args, align_blanks(), c_ids[1]); });
+        if (chash) {
+            auto const & right_rows = chash->hash().rows();
+            table.owner = chash;
+            table.rows = &right_rows;
+            std::vector<unsigned char> matched(outer ? right_rows.rows() : 0);
+            rows = probe_keys(tuples.size(), key_of, chash->hash(), keep_left, outer ? &matched : nullptr);
+            for (std::size_t r = 0; r < matched.size(); ++r)
+                if (!matched[r])
+                    rows.push_back({no_row, r});
+        } else {
+            if (keep_left)
+                for (std::size_t t = 0; t < tuples.size(); ++t)
+                    rows.push_back({t, no_row});
+            if (outer && !comparable) {
+                if (auto right_rows = unless_empty([&] { return std::make_shared<rows_type>(reader, args); })) {
+                    table.owner = right_rows;
+                    table.rows = right_rows.get();
+                    for (std::size_t r = 0; r < right_rows->rows(); ++r)
+                        rows.push_back({no_row, r});
+                }
+            }
+        }
+
+        bool const left_missing = std::any_of(rows.begin(), rows.end(), [](auto const & row) { return row.left == no_row; });
+        bool const right_missing = std::any_of(rows.begin(), rows.end(), [](auto const & row) { return row.right == no_row; });
+        tuples = tuples.extended(rows);
+        tables.push_back(std::move(table));
+        merge_stage(outer ? exclude_c_column::no : exclude_c_column::yes);
+
+        // The columns of a missing side get blanks, and with --blanks they are text: what typifying the result would
+        // tell a later stage or an honest outer join
+        if (outer && (args.honest_outer_join || file + 1 < files)) {
+            auto & types = std::get<0>(ts_n_blanks[0]);
+            auto & blanks = std::get<1>(ts_n_blanks[0]);
+            for (std::size_t c = 0; c < types.size(); ++c) {
+                if (c < left_cols ? left_missing : right_missing) {
+                    blanks[c] = 1;
+                    if (args.blanks)
+                        types[c] = column_type::text_t;
+                }
+            }
+        }
+    }
+
+    late_output = [tables = std::move(tables), tuples = std::make_shared<row_tuples const>(std::move(tuples)), &ts_n_blanks, &args](std::ostream & os) {
+        printer p(os);
+        p.write(tables, *tuples, ts_n_blanks[0], args);
+    };
+};
+
+//------------------- This is just a code to inline it "in place" by the C preprocessor directive #include. See csvJoin.cpp --------------
@@ -0,0 +1,18 @@
+//------------------- This is just a code to inline it "in place" by the C preprocessor directive #include. See csvJoin.cpp --------------
+
+/// Result rows of the last join stage, printed straight from the cells of the joined tables by print_results
+std::function<void(std::ostream &)> late_output;
+
+/// Turns joined rows into strings, for a later join stage to take them as its table
+auto materialize = [](reader_fake<reader_type> & impl, auto & left, auto const & right, join_shape const & shape, std::vector<joined_row> const & rows) {
+    for (auto const & row : rows) {
+        std::vector<std::string> cells;
+        cells.reserve(shape.left_cols + shape.right_cols);
+        for_each_joined_cell(left, right, shape, row, [&](auto const & cell) {
+            cells.emplace_back(std::string(cell));
+        });
+        impl.add(std::move(cells));
+    }
+};
+
+//------------------- This is just a code to inline it "in place" by the C preprocessor directive #include. See csvJoin.cpp --------------
@@ -0,0 +1,79 @@
+//------------------- This is just a code to inline it "in place" by the C preprocessor directive #include. See csvJoin.cpp --------------
+
+auto presorted_join = [&deq, &ts_n_blanks, &c_ids, &args, &cycle_cleanup, &merge_stage, &can_compare, &align_blanks, &materialize, &late_output] {
+    assert(!c_ids.empty());
+    if (args.outer_join && deq.size() > 2)
+        throw std::runtime_error("A presorted outer join takes two files only.");
+
+    using elem_type = typename reader_type::template typed_span<csv_co::quoted>;
+    bool const keep_left = args.left_join || args.right_join || args.outer_join;
+    bool const keep_right = args.outer_join;
+    auto const files = deq.size();
+    // Numbers the sources as the command line does
+    auto input_name = [&](std::size_t i) {
+        return "Input file " + std::to_string(args.right_join ? files - i : i + 1);
+    };
+
+    while (deq.size() > 1) {
+#if !defined(__clang__) || __clang_major__ >= 16
+        auto & [types0, blanks0] = ts_n_blanks[0];
+        auto & [types1, blanks1] = ts_n_blanks[1];
+#else
+        auto & types0 = std::get<0>(ts_n_blanks[0]);
+        auto & types1 = std::get<0>(ts_n_blanks[1]);
+        auto & blanks0 = std::get<1>(ts_n_blanks[0]);
+        auto & blanks1 = std::get<1>(ts_n_blanks[1]);
+#endif
+        reader_fake<reader_type> impl{0, 0};
+        auto const stage = files - deq.size();
+        bool const last_stage = deq.size() == 2;
+        bool const comparable = can_compare(types0, types1, blanks0, blanks1);
+        join_shape const shape{types0.size(), types1.size(), args.outer_join ? std::vector<unsigned>{} : c_ids[1]};
+        std::array<std::string, 2> const names{stage ? "The joined result" : input_name(0), input_name(stage + 1)};
+        // a presorted join has a single join column a file, see check_arg_semantics
+        auto const compare = std::get<1>(obtain_compare_functionality<elem_type>(c_ids[1].front(), align_blanks(), args));
+        auto const left_column = c_ids[0].front();
+        auto const right_column = c_ids[1].front();
+
+        assert(!std::holds_alternative<reader_fake<reader_type>>(deq[1]));
+        auto * const this_source = std::addressof(deq.front());
+        auto * const other_reader = std::addressof(std::get<0>(deq[1]));
+
+        // Walks both sources with the joined rows going to emit
+        auto run = [this_source, other_reader, left_column, right_column, compare, comparable, keep_left, keep_right, names, &args](auto && emit) {
+            std::visit([&](auto & arg) {
+                try {
+                    row_pump<reader_type, elem_type> right(*other_reader, args);
+                    if constexpr(std::is_same_v<std::decay_t<decltype(arg)>, reader_type>) {
+                        row_pump<reader_type, elem_type> left(arg, args);
+                        merge_join(left, left_column, right, right_column, compare, comparable, keep_left, keep_right, names, emit);
+                    } else {
+                        using table_type = typename reader_fake<reader_type>::table;
+                        table_cursor<table_type, elem_type> left(arg.operator table_type &());
+                        merge_join(left, left_column, right, right_column, compare, comparable, keep_left, keep_right, names, emit);
+                    }
+                } catch (typename reader_type::implementation_exception const &) {}
+            }, *this_source);
+        };
+
+        if (last_stage) {
+            // the rows are printed while the sources are walked, the sources stay in the queue
+            late_output = [run, shape, &ts_n_blanks, &args](std::ostream & os) {
+                printer p(os);
+                run([&](auto const & left, auto const & right, std::vector<joined_row> const & rows) {
+                    p.write(left, right, shape, rows, ts_n_blanks[0], args);
+                });
+            };
+            merge_stage(args.outer_join ? exclude_c_column::no : exclude_c_column::yes);
+            return;
+        }
+
+        run([&](auto const & left, auto const & right, std::vector<joined_row> const & rows) {
+            materialize(impl, left, right, shape, rows);
+        });
+        cycle_cleanup();
+        deq.push_front(std::move(impl));
+    }
+};
+
+//------------------- This is just a code to inline it "in place" by the C preprocessor directive #include. See csvJoin.cpp --------------
@@ -0,0 +1,120 @@
+///
+/// \file   suite/include/literal-set.h
+/// \author wiluite
+/// \brief  Case-insensitive lookup of short literals (null, boolean, inf/nan) without copying the cell.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace csv_co::csvsuite {
+
+    /// A set of literals compared ignoring the ASCII case. Literals are bucketed by length, and every bucket
+    /// keeps a bitmap of its (upper-cased) first characters, so the most of the cells are rejected after
+    /// two bit tests, and a match costs a single case-folding comparison with one or two literals.
+    class literal_set {
+    public:
+        /// Returned by find() when there is no such literal
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+        literal_set() = default;
+        literal_set(std::initializer_list<std::string_view> literals) {
+            for (auto e : literals)
+                insert(e);
+        }
+
+        /// Adds a literal, it is stored upper-cased
+        void insert(std::string_view literal) {
+            std::string upper(literal);
+            for (auto & c : upper)
+                c = fold(c);
+            for (auto const & e : literals_)
+                if (e == upper)
+                    return;
+            auto const index = literals_.size();
+            literals_.push_back(std::move(upper));
+            auto const & stored = literals_.back();
+            auto & b = bucket_of(stored.size());
+            b.indexes.push_back(index);
+            if (!stored.empty())
+                b.first_chars[static_cast<unsigned char>(stored.front()) >> 6] |= std::uint64_t{1} << (static_cast<unsigned char>(stored.front()) & 63);
+            if (stored.size() < 64)
+                lengths_ |= std::uint64_t{1} << stored.size();
+            else
+                has_long_ = true;
+        }
+
+        void clear() noexcept {
+            literals_.clear();
+            for (auto & b : buckets_)
+                b = bucket{};
+            long_bucket_ = bucket{};
+            lengths_ = 0;
+            has_long_ = false;
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return literals_.empty();
+        }
+
+        /// Index of the literal equal to sv ignoring the case, or npos
+        [[nodiscard]] std::size_t find(std::string_view sv) const noexcept {
+            if (sv.size() < 64 ? !(lengths_ & (std::uint64_t{1} << sv.size())) : !has_long_)
+                return npos;
+            auto const & b = sv.size() < buckets_.size() ? buckets_[sv.size()] : long_bucket_;
+            if (!sv.empty()) {
+                auto const first = static_cast<unsigned char>(fold(sv.front()));
+                if (!(b.first_chars[first >> 6] & (std::uint64_t{1} << (first & 63))))
+                    return npos;
+            }
+            for (auto const index : b.indexes) {
+                auto const & literal = literals_[index];
+                if (literal.size() == sv.size() && equal_folded(sv, literal))
+                    return index;
+            }
+            return npos;
+        }
+
+        [[nodiscard]] bool contains(std::string_view sv) const noexcept {
+            return find(sv) != npos;
+        }
+
+        /// The upper-cased literal found at the index
+        [[nodiscard]] std::string_view operator[](std::size_t index) const noexcept {
+            return literals_[index];
+        }
+
+    private:
+        struct bucket {
+            std::vector<std::size_t> indexes;
+            std::array<std::uint64_t, 4> first_chars {};
+        };
+
+        /// ASCII case folding, which is what ::toupper does in the "C" locale
+        static constexpr char fold(char c) noexcept {
+            return c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c;
+        }
+
+        static bool equal_folded(std::string_view sv, std::string_view upper) noexcept {
+            for (std::size_t i = 0; i < sv.size(); ++i)
+                if (fold(sv[i]) != upper[i])
+                    return false;
+            return true;
+        }
+
+        bucket & bucket_of(std::size_t size) noexcept {
+            return size < buckets_.size() ? buckets_[size] : long_bucket_;
+        }
+
+        std::vector<std::string> literals_;
+        std::array<bucket, 16> buckets_;
+        bucket long_bucket_;
+        std::uint64_t lengths_ {0};
+        bool has_long_ {false};
+    };
+}
@@ -13,7 +13,11 @@
 #include <../external/vince-csv-parser/data_type.h>
 #include <unordered_set>
 #include <deque>
+#include <charconv>
+#include <array>
 #include "../external/date/date.h"
+#include "strptime-program.h"
+#include "literal-set.h"
 #include <codecvt>
 #include "../external/Alphabet-AB/UtfConv.c"
 
@@ -179,8 +183,19 @@ namespace csv_co {
         return str;
     }
 
+    /// Looks a cell up in a literal set. A cell with no quotes and no white spaces around is probed in place,
+    /// others are unquoted and trimmed the way toupper_cell_string() does it
+    template<TrimPolicyConcept T, bool Unquoted>
+    inline std::size_t find_cell_literal(auto & cell_span, csvsuite::literal_set const & set) {
+        auto const sv = cell_span.raw_string_view();
+        auto const space = [](char c) { return c == ' ' or (c >= '\t' and c <= '\r'); };
+        if (sv.find('"') == std::string_view::npos and (sv.empty() or (!space(sv.front()) and !space(sv.back()))))
+            return set.find(sv);
+        return set.find(toupper_cell_string<T, Unquoted>(cell_span));
+    }
+
     inline auto & get_inf_nan_set() {
-        static std::unordered_set<std::string_view> inf_nan_set {"NAN", "INF", "INFINITY", "+INF", "-INF", "+INFINITY", "-INFINITY"};
+        static csvsuite::literal_set inf_nan_set {"NAN", "INF", "INFINITY", "+INF", "-INF", "+INFINITY", "-INFINITY"};
         return inf_nan_set;
     }
 
@@ -231,9 +246,10 @@ namespace csv_co {
         }
 
         if (static_cast<DataType>(type_) == DataType::CSV_STRING) {
-            auto const iter = get_inf_nan_set().find(toupper_cell_string<T, Unquoted>(*this));
-            if (iter != get_inf_nan_set().end()) {
-                value = *iter == "NAN" ? std::nanl("nan") : ((*iter)[0] == '-' ? -INFINITY : INFINITY);
+            auto const index = find_cell_literal<T, Unquoted>(*this, get_inf_nan_set());
+            if (index != csvsuite::literal_set::npos) {
+                auto const literal = get_inf_nan_set()[index];
+                value = literal == "NAN" ? std::nanl("nan") : (literal[0] == '-' ? -INFINITY : INFINITY);
                 type_ = static_cast<signed char>(DataType::CSV_DOUBLE);
                 prec = 0;
             }
@@ -322,7 +338,7 @@ namespace csv_co {
     }
 
     inline auto & get_none_set() {
-        static std::unordered_set<std::string_view> default_none_set {"NA", "N/A", "NONE", "NULL", ".", ","};
+        static csvsuite::literal_set default_none_set {"NA", "N/A", "NONE", "NULL", ".", ","};
         return default_none_set;
     }
 
@@ -331,11 +347,11 @@ namespace csv_co {
     bool reader<T, Q, D, L, M, E>::typed_span<Unquoted>::is_null() const {
         if (is_nil())
             return true;
-        return static_cast<DataType>(type_) == DataType::CSV_STRING and get_none_set().find(toupper_cell_string<T, Unquoted>(*this)) != get_none_set().end();
+        return static_cast<DataType>(type_) == DataType::CSV_STRING and find_cell_literal<T, Unquoted>(*this, get_none_set()) != csvsuite::literal_set::npos;
     }
 
     inline auto & get_null_value_set() {
-        static std::unordered_set<std::string_view> null_value_set {};
+        static csvsuite::literal_set null_value_set {};
         return null_value_set;
     }
 
@@ -344,7 +360,7 @@ namespace csv_co {
     bool reader<T, Q, D, L, M, E>::typed_span<Unquoted>::is_null_value() const {
         if (is_nil())
             return false;
-        return static_cast<DataType>(type_) == DataType::CSV_STRING and get_null_value_set().find(toupper_cell_string<T, Unquoted>(*this)) != get_null_value_set().end();
+        return static_cast<DataType>(type_) == DataType::CSV_STRING and find_cell_literal<T, Unquoted>(*this, get_null_value_set()) != csvsuite::literal_set::npos;
     }
 
     template<TrimPolicyConcept T, QuoteConcept Q, DelimiterConcept D, LineBreakConcept L, MaxFieldSizePolicyConcept M, EmptyRowsPolicyConcept E>
@@ -354,8 +370,8 @@ namespace csv_co {
             return true;
         if (static_cast<DataType>(type_) != DataType::CSV_STRING)
             return false;
-        return get_none_set().find(toupper_cell_string<T, Unquoted>(*this)) != get_none_set().end() or
-               get_null_value_set().find(toupper_cell_string<T, Unquoted>(*this)) != get_null_value_set().end();
+        return find_cell_literal<T, Unquoted>(*this, get_none_set()) != csvsuite::literal_set::npos or
+               (!get_null_value_set().empty() and find_cell_literal<T, Unquoted>(*this, get_null_value_set()) != csvsuite::literal_set::npos);
     }
 
     template<TrimPolicyConcept T, QuoteConcept Q, DelimiterConcept D, LineBreakConcept L, MaxFieldSizePolicyConcept M, EmptyRowsPolicyConcept E>
@@ -371,7 +387,7 @@ namespace csv_co {
     }
 
     inline auto & get_bool_set() {
-        static std::unordered_set<std::string_view> bool_set {"T", "F", "TRUE", "FALSE", "\"1\"", "\"0\"", "Y", "N", "YES", "NO"};
+        static csvsuite::literal_set bool_set {"T", "F", "TRUE", "FALSE", "\"1\"", "\"0\"", "Y", "N", "YES", "NO"};
         return bool_set;
     }
 
@@ -382,9 +398,10 @@ namespace csv_co {
         if (static_cast<DataType>(type_) == DataType::CSV_INT8 && (value == 0 or value == 1))
             return true;
         else if (static_cast<DataType>(type_) == DataType::CSV_STRING) {
-            auto const str = toupper_cell_string<T,Unquoted>(*this);
-            auto const result = get_bool_set().find(str) != get_bool_set().end();
+            auto const index = find_cell_literal<T, Unquoted>(*this, get_bool_set());
+            auto const result = index != csvsuite::literal_set::npos;
             if (result) {
+                auto const str = get_bool_set()[index];
                 // update value for get_bool() function use.
                 value = (str == "F" || str == "FALSE" || str == "\"0\"" || str == "N" || str == "NO") ? 0 : 1;
                 // we now are able to change inner type for better caching.
@@ -533,10 +550,23 @@ namespace csv_co {
                     fun_impl = [&](typed_span const & span, std::vector<std::string> & formats) -> std::tuple<bool, date::sys_seconds> {
 
                         date::sys_seconds tp;
-                        std::string trimmed = span;
-                        trimmed.erase(0, trimmed.find_first_not_of(' '));
+                        // A plain cell is parsed in place, otherwise it has to be unquoted and trimmed first
+                        std::string converted;
+                        std::string_view trimmed = span.raw_string_view();
+                        trimmed.remove_prefix(std::min(trimmed.find_first_not_of(' '), trimmed.size()));
+                        if (trimmed.find('"') != std::string_view::npos or (!trimmed.empty() and std::isspace(static_cast<unsigned char>(trimmed.front())))) {
+                            converted = span;
+                            converted.erase(0, converted.find_first_not_of(' '));
+                            trimmed = converted;
+                        }
                         for (auto const &fmt : formats) {
-                            std::istringstream in {trimmed};
+                            using verdict = csvsuite::strptime_program::verdict;
+                            auto const v = csvsuite::compiled_strptime_format(fmt)(trimmed, tp);
+                            if (v == verdict::match)
+                                return std::tuple{true, tp};
+                            if (v == verdict::mismatch)
+                                continue;
+                            std::istringstream in {std::string(trimmed)};
                             in >> date::parse(fmt, tp);
                             if (in.fail() or in.bad())
                                 continue;
@@ -640,11 +670,6 @@ namespace csv_co {
             NANO
         };
 
-        template<class SS, class... Ts>
-        void time_to_stream(SS & ss, Ts&&... ts) const {
-            (ss << ... << std::forward<Ts>(ts));
-        }
-
         [[nodiscard]] std::string str(output_resolution r = output_resolution::MICRO) const {
             if (r == output_resolution::MICRO) {
                 microseconds_ = static_cast<decltype(microseconds_)>(round<std::chrono::microseconds>(rest_).count());
@@ -654,17 +679,35 @@ namespace csv_co {
                 nanoseconds_ = static_cast<decltype(microseconds_)>(round<std::chrono::nanoseconds>(rest_ - floor<std::chrono::microseconds>(rest_)).count());
             }
 
-            std::stringstream ss;
-            ss.imbue(std::locale("C"));
-            ss.fill('0');
-            if (days_)
-                time_to_stream(ss, days_, (days_ == 1 ? " day, " : " days, "));
-            time_to_stream(ss,  std::setw(clock_hours_ > 9 ? 2 : 1), clock_hours_, ":", std::setw(2), clock_minutes_, ":", std::setw(2), clock_seconds_);
-            if (microseconds_)
-                time_to_stream(ss, '.', microseconds_);
-            if (nanoseconds_)
-                time_to_stream(ss, ',', nanoseconds_, "ns");
-            return ss.str();
+            std::array<char, 64> buf;
+            auto cur = buf.data();
+            auto put_num = [&](unsigned num, unsigned width) {
+                if (width == 2 and num < 10)
+                    *cur++ = '0';
+                cur = std::to_chars(cur, buf.data() + buf.size(), num).ptr;
+            };
+            auto put_str = [&](std::string_view str) {
+                cur = std::copy(str.begin(), str.end(), cur);
+            };
+            if (days_) {
+                put_num(days_, 1);
+                put_str(days_ == 1 ? " day, " : " days, ");
+            }
+            put_num(clock_hours_, 1);
+            *cur++ = ':';
+            put_num(clock_minutes_, 2);
+            *cur++ = ':';
+            put_num(clock_seconds_, 2);
+            if (microseconds_) {
+                *cur++ = '.';
+                put_num(microseconds_, 1);
+            }
+            if (nanoseconds_) {
+                *cur++ = ',';
+                put_num(nanoseconds_, 1);
+                put_str("ns");
+            }
+            return {buf.data(), cur};
         }
 
         std::size_t seconds_ {};
@@ -700,6 +743,28 @@ namespace csv_co {
     class time_parser {
     private:
         time_storage tm_storage;
+
+        /// Character classes of the "C" locale, whatever the global locale is
+        static constexpr bool is_space(char c) noexcept { return c == ' ' or (c >= '\t' and c <= '\r'); }
+        static constexpr bool is_digit(char c) noexcept { return c >= '0' and c <= '9'; }
+        static constexpr bool is_alpha(char c) noexcept { return (c >= 'a' and c <= 'z') or (c >= 'A' and c <= 'Z'); }
+
+        static constexpr std::size_t max_unit_length = 7;
+        struct unit_group {
+            std::array<std::string_view, 5> names;
+            std::size_t size;
+            long double seconds;
+        };
+        /// Unit synonyms in the only order they may follow each other
+        static constexpr std::array<unit_group, 5> unit_groups {{
+              {{"w", "wk", "week", "weeks"}, 4, 604800}
+            , {{"d", "day", "days"}, 3, 86400}
+            , {{"h", "hr", "hrs", "hour", "hours"}, 5, 3600}
+            , {{"m", "min", "mins", "minute", "minutes"}, 5, 60}
+            , {{"s", "sec", "secs", "second", "seconds"}, 5, 1}
+        }};
+        /// Seconds of the d:hh:mm:ss notation fields
+        static constexpr std::array<long double, 4> clock_units {86400, 3600, 60, 1};
     public:
         operator long double() const {
             auto const microsecs = static_cast<double>(floor<std::chrono::microseconds>(tm_storage.rest_).count());
@@ -710,6 +775,7 @@ namespace csv_co {
         time_parser(time_parser && other) = delete;
         time_parser& operator=(time_parser && other) = delete;
 
+        /// Parses a timedelta in a single pass over the view, allocating nothing
         bool parse(std::string_view sv) {
             auto const end = sv.find_last_not_of(" \r\t\n");
             auto const beg = sv.find_first_not_of(" \r\t\n");
@@ -728,185 +794,143 @@ namespace csv_co {
             if (semicolons > max_possible_semicolons)
                 return false;
 
-            auto duplicated_essences = [&] {
-                return std::min(semicolons, max_possible_semicolons) == max_possible_semicolons and sv.find_first_of("wd") != std::string_view::npos;
-            };
-            if (duplicated_essences())
+            if (semicolons == max_possible_semicolons and sv.find_first_of("wd") != std::string_view::npos)
                 return false;
 
-            std::deque<std::vector<std::string>> sym_deq {
-                      {"w", "wk", "week", "weeks"}
-                    , {"d", "day", "days"}
-                    , {"h", "hr", "hrs", "hour", "hours"}
-                    , {"m", "min", "mins", "minute", "minutes"}
-                    , {"s", "sec", "secs", "second", "seconds"}
-            };
+            // clock units still expected in the d:hh:mm:ss notation, and word unit groups still expected
+            auto clock_front = semicolons ? clock_units.size() - 1 - static_cast<std::size_t>(semicolons) : clock_units.size();
+            std::size_t group_front = 0;
 
-            std::unordered_map<std::string, long double> sym_to_sec {
-                      {"w", 604800}, {"wk", 604800}, {"week", 604800}, {"weeks", 604800}
-                    , {"d", 86400}, {"day", 86400}, {"days", 86400}
-                    , {"h", 3600}, {"hr", 3600}, {"hrs", 3600}, {"hour", 3600}, {"hours", 3600}
-                    , {"m", 60}, {"min", 60}, {"mins", 60}, {"minute", 60}, {"minutes", 60}
-                    , {"s", 1}, {"sec", 1}, {"secs", 1}, {"second", 1}, {"seconds", 1}
-            };
-
-            std::deque<long double> sec_deq;
-
-            if (semicolons) {
-                sec_deq.push_back(60);
-                sec_deq.push_back(1);
-            }
-
-            if (semicolons > 1)
-                sec_deq.push_front(3600);
-
-            if (semicolons > 2)
-                sec_deq.push_front(86400);
-
-            enum class fun_type {digit, complete_time, word};
-            fun_type next_fun = fun_type::digit;
+            enum class state {digit, complete_time, word};
+            state next = state::digit;
+            bool initial = true;
             char c;
+            unsigned char commas = 0;
+            std::string_view recent_num;
+            std::chrono::duration<long double, std::ratio<1>> total_sec {0};
 
-            auto initial_space_func = [&c, &cursor] {
-                c = *cursor++;
-                return true;
+            auto skip_spaces = [&] {
+                if (commas > 1)
+                    return false;
+                for(;;) {
+                    if (cursor == e or (c == ',' and ++commas > 1))
+                        return false;
+                    if (!is_space(c = *cursor++) and c != ',')
+                        return true;
+                }
             };
 
-            std::function<bool()> space_fn = initial_space_func;
-            std::chrono::duration<long double, std::ratio<1>> total_sec {0};
+            // the number begins with the character just read
+            auto compose_num = [&] {
+                auto const first = cursor - 1;
+                auto last = cursor;
+                unsigned dots = 0;
+                while (cursor != e) {
+                    c = *cursor++;
+                    dots += c == '.' ? 1 : 0;
+                    if (dots > 1 or !(is_digit(c) or c == '.'))
+                        break;
+                    last = cursor;
+                }
+                return std::string_view{&*first, static_cast<std::size_t>(last - first)};
+            };
 
-            unsigned char commas = 0;
+            auto inc_sec = [&](long double unit) {
+                long double val {};
+                std::from_chars(recent_num.data(), recent_num.data() + recent_num.size(), val);
+                total_sec += std::chrono::duration<long double, std::ratio<1>>(val * unit);
+            };
 
-            std::string recent_num;
-            std::locale loc {"C"};
+            auto inc_clock_sec = [&] {
+                if (clock_front == clock_units.size())
+                    return false;
+                inc_sec(clock_units[clock_front++]);
+                return true;
+            };
 
             while (cursor != e) {
-                auto space_fun = [&c, &cursor, &commas, &e, &loc] {
-                    if (commas > 1)
-                        return false;
-                    for(;;) {
-                        if (cursor == e or (c == ',' and ++commas > 1))
-                            return false;
-                        if (!(std::isspace(c = *cursor++, loc)) and c != ',')
-                            return true;
-                    }
-                };
-
-                auto compose_num = [&c, &cursor, &e, &loc] {
-                    unsigned dots = 0;
-                    auto num_char = [&c, &cursor, &dots, &loc] {
-                        c = *cursor++;
-                        dots += c == '.' ? 1 : 0;
-                        return (dots < 2 and (std::isdigit(c, loc) or c == '.'));
-                    };
-                    std::string s;
-                    do s += c; while (cursor != e and num_char());
-                    return s;
-                };
-
-                auto inc_sec = [&recent_num, &total_sec] (auto const & num) {
-                    struct sstringstream : std::stringstream {
-                        sstringstream() : std::stringstream() { imbue(std::locale("C")); }
-                    };
-                    sstringstream ss;
-                    ss << recent_num;
-                    long double val;
-                    ss >> val;
-                    total_sec += std::chrono::duration<long double, std::ratio<1>>(val * num);
-                };
-
-                auto digit_fun = [&space_fn, &c, &space_fun, &compose_num, &cursor, &recent_num, &inc_sec, &sec_deq, &next_fun, &commas, &loc] {
-                    if (!space_fn() or !std::isdigit(c, loc))
-                        return false;
-                    if (space_fn.target<decltype(initial_space_func)>())
-                        space_fn = space_fun;
-                    recent_num = compose_num();
-                    --cursor;
-                    if (c == ':') {
-                        if (recent_num.find('.') != std::string::npos)
+                switch (next) {
+                    case state::digit: {
+                        if (initial)
+                            c = *cursor++;
+                        else if (!skip_spaces())
                             return false;
-                        inc_sec(sec_deq.front());
-                        sec_deq.pop_front();
-                        next_fun = fun_type::complete_time;
-                    } else {
-                        commas = 0;
-                        next_fun = fun_type::word;
-                    }
-                    return true;
-                };
-
-                auto complete_time_fun = [&cursor, &e, &c, &recent_num, &compose_num, &inc_sec, &sec_deq, &loc] {
-                    if (++cursor == e or !(std::isdigit(c = *cursor++, loc)))
-                        return false;
-                    recent_num = compose_num();
-                    if (cursor == e and std::isdigit(*(cursor - 1), loc)) {
-                        auto const dot_pos = recent_num.find_first_of('.');
-                        if ((dot_pos != std::string::npos and dot_pos != 2) or (dot_pos == std::string::npos and recent_num.size() != 2))
+                        if (!is_digit(c))
                             return false;
-                        inc_sec(sec_deq.front());
-                        sec_deq.pop_front();
-                        return true;
+                        initial = false;
+                        recent_num = compose_num();
+                        --cursor;
+                        if (c == ':') {
+                            if (recent_num.find('.') != std::string_view::npos or !inc_clock_sec())
+                                return false;
+                            next = state::complete_time;
+                        } else {
+                            commas = 0;
+                            next = state::word;
+                        }
+                        break;
                     }
-                    --cursor;
-                    if (c == ':') {
-                        if (recent_num.find('.') != std::string::npos or recent_num.size() != 2)
+                    case state::complete_time: {
+                        if (++cursor == e or !is_digit(c = *cursor++))
                             return false;
-                    } else {
-                        while(cursor != e) {
-                            if (!std::isspace(*cursor++, loc))
+                        recent_num = compose_num();
+                        if (cursor == e and is_digit(*(cursor - 1))) {
+                            auto const dot_pos = recent_num.find_first_of('.');
+                            if ((dot_pos != std::string_view::npos and dot_pos != 2) or (dot_pos == std::string_view::npos and recent_num.size() != 2))
+                                return false;
+                            if (!inc_clock_sec())
                                 return false;
+                            break;
                         }
+                        --cursor;
+                        if (c == ':') {
+                            if (recent_num.find('.') != std::string_view::npos or recent_num.size() != 2)
+                                return false;
+                        } else {
+                            while (cursor != e) {
+                                if (!is_space(*cursor++))
+                                    return false;
+                            }
+                        }
+                        if (!inc_clock_sec())
+                            return false;
+                        break;
                     }
-                    inc_sec(sec_deq.front());
-                    sec_deq.pop_front();
-                    return true;
-                };
-
-                auto word_fun = [&space_fun, &c, &cursor, &e, &commas, &sym_deq, &inc_sec, &sym_to_sec, &next_fun, &loc] {
-                    if (!space_fun() or !(std::isalpha(c, loc)))
-                        return false;
-
-                    auto isalpha_or_comma = [&] {
-                        return std::isalpha(c = *cursor++, loc) || c == ',';
-                    };
-                    std::string word;
-                    do {
-                        if (c != ',')
-                            word += c;
-                        else
-                            ++commas;
-                    }
-                    while (cursor != e and isalpha_or_comma());
-                    for (;;) {
-                        if (sym_deq.empty())
+                    case state::word: {
+                        if (!skip_spaces() or !is_alpha(c))
                             return false;
-                        auto const & front = sym_deq.front();
-                        bool found = false;
-                        for (auto & elem : front) {
-                            if (elem == word) {
-                                inc_sec(sym_to_sec[elem]);
-                                found = true;
+                        // a word with commas dropped; longer words than any unit name can not match
+                        std::array<char, max_unit_length> word_buf;
+                        std::size_t word_len = 0;
+                        bool too_long = false;
+                        for (;;) {
+                            if (c != ',') {
+                                if (word_len < word_buf.size())
+                                    word_buf[word_len++] = c;
+                                else
+                                    too_long = true;
+                            } else
+                                ++commas;
+                            if (cursor == e or !(is_alpha(c = *cursor++) or c == ','))
+                                break;
+                        }
+                        std::string_view const word {word_buf.data(), word_len};
+                        for (;;) {
+                            if (group_front == unit_groups.size())
+                                return false;
+                            auto const & group = unit_groups[group_front++];
+                            if (!too_long and std::find(group.names.begin(), group.names.begin() + group.size, word) != group.names.begin() + group.size) {
+                                inc_sec(group.seconds);
                                 break;
                             }
                         }
-                        sym_deq.pop_front();
-                        if (found)
+                        if (cursor == e and is_alpha(*(cursor - 1)))
                             break;
+                        --cursor;
+                        next = state::digit;
+                        break;
                     }
-
-                    if (cursor == e and std::isalpha(*(cursor - 1), loc))
-                        return true;
-
-                    --cursor;
-                    next_fun = fun_type::digit;
-                    return true;
-                };
-
-                std::unordered_map<fun_type, std::function<bool()>>
-                    fun_map = {{fun_type::digit, digit_fun}, {fun_type::complete_time, complete_time_fun}, {fun_type::word, word_fun}};
-
-                if (!fun_map[next_fun]())
-                    return false;
+                }
             }
 
             tm_storage.seconds_ = static_cast<decltype(tm_storage.seconds_)>(floor<std::chrono::seconds>(total_sec).count());
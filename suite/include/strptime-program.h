@@ -0,0 +1,221 @@
+///
+/// \file   suite/include/strptime-program.h
+/// \author wiluite
+/// \brief  Date and datetime formats compiled into allocation-free parsing programs.
+
+#pragma once
+
+#include <array>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <deque>
+#include "../external/date/date.h"
+
+namespace csv_co::csvsuite {
+
+    /// A strptime-like format compiled once into a fixed sequence of digit-field and literal operations.
+    /// It reproduces date::parse() exactly for the locale-independent directives (%Y %m %d %e %H %I %M %S %F %T %R %%,
+    /// white spaces and literals). Locale-dependent or unsupported directives (%p, %b, %EY, ...) and characters which
+    /// may be a locale decimal point leave the decision to date::parse().
+    class strptime_program {
+    public:
+        /// The outcome of a run
+        enum class verdict {
+            match,
+            mismatch,
+            undecided
+        };
+
+        explicit strptime_program(std::string_view fmt) {
+            // the last slot is kept for the undecided marker of an incomplete program
+            auto push = [&](op_code code, char ch = '\0', unsigned char min_width = 0, unsigned char max_width = 0) {
+                if (size_ == ops_.size() - 1)
+                    return false;
+                ops_[size_++] = op{code, ch, min_width, max_width};
+                return true;
+            };
+            for (auto it = fmt.begin(); it != fmt.end(); ++it) {
+                auto const c = *it;
+                auto const size = size_;
+                bool pushed;
+                if (c != '%')
+                    pushed = std::isspace(static_cast<unsigned char>(c)) ? push(op_code::spaces) : push(op_code::literal, c);
+                else if (++it == fmt.end())
+                    break;
+                else switch (*it) {
+                    case '%': pushed = push(op_code::literal, '%'); break;
+                    case 'Y': pushed = push(op_code::year, '\0', 1, 4); break;
+                    case 'm': pushed = push(op_code::month, '\0', 1, 2); break;
+                    case 'd':
+                    case 'e': pushed = push(op_code::day, '\0', 1, 2); break;
+                    case 'H': pushed = push(op_code::hour, '\0', 1, 2); break;
+                    case 'I': pushed = push(op_code::hour_12, '\0', 1, 2); break;
+                    case 'M': pushed = push(op_code::minute, '\0', 1, 2); break;
+                    case 'S': pushed = push(op_code::second, '\0', 1, 2); break;
+                    case 'F':
+                        pushed = push(op_code::year, '\0', 1, 4) && push(op_code::literal, '-') && push(op_code::unsigned_month, '\0', 1, 2)
+                              && push(op_code::literal, '-') && push(op_code::unsigned_day, '\0', 1, 2);
+                        break;
+                    case 'T':
+                        pushed = push(op_code::unsigned_hour, '\0', 1, 2) && push(op_code::literal, ':') && push(op_code::minute, '\0', 1, 2)
+                              && push(op_code::literal, ':') && push(op_code::second, '\0', 1, 2);
+                        break;
+                    case 'R':
+                        pushed = push(op_code::unsigned_hour, '\0', 1, 2) && push(op_code::literal, ':') && push(op_code::minute, '\0', 1, 2);
+                        break;
+                    default: pushed = false;
+                }
+                if (!pushed) {
+                    size_ = size; // no part of a directive left behind
+                    break;
+                }
+                consumed_ = static_cast<std::size_t>(it - fmt.begin()) + 1;
+            }
+            complete_ = consumed_ == fmt.size();
+            if (!complete_)
+                ops_[size_++] = op{op_code::undecided, '\0', 0, 0};
+        }
+
+        /// Runs the program over a cell with its leading spaces already skipped
+        verdict operator()(std::string_view sv, date::sys_seconds & tp) const noexcept {
+            // the same "not a value" markers date::parse() uses, for the same field conflict semantics
+            constexpr int not_a_year = std::numeric_limits<short>::min();
+            constexpr int not_a_month_or_day = 0;
+            constexpr int not_a_hour_12 = 0;
+            constexpr int not_a_hour_or_minute = std::numeric_limits<int>::min();
+            constexpr int not_a_second = -1;
+            int Y = not_a_year, m = not_a_month_or_day, d = not_a_month_or_day, I = not_a_hour_12;
+            int H = not_a_hour_or_minute, M = not_a_hour_or_minute, S = not_a_second;
+            auto cur = sv.begin();
+            auto const end = sv.end();
+
+            auto set = [](int & field, int value, int not_a_value) {
+                if (field != not_a_value && field != value)
+                    return false;
+                field = value;
+                return true;
+            };
+            // Possible locale decimal points: it is the locale to decide
+            auto dubious = [](char c) {
+                return c == '.' || c == ',' || static_cast<unsigned char>(c) >= 0x80;
+            };
+
+            for (auto i = 0u; i < size_; ++i) {
+                auto const & o = ops_[i];
+                if (o.code == op_code::undecided)
+                    return verdict::undecided;
+                if (o.code == op_code::spaces) {
+                    for (; cur != end && std::isspace(static_cast<unsigned char>(*cur)); ++cur);
+                    if (cur != end && static_cast<unsigned char>(*cur) >= 0x80)
+                        return verdict::undecided;
+                    continue;
+                }
+                if (o.code == op_code::literal) {
+                    if (cur == end || *cur != o.ch)
+                        return verdict::mismatch;
+                    ++cur;
+                    continue;
+                }
+
+                // digit fields
+                bool negative = false;
+                unsigned max_width = o.max_width;
+                if (o.code == op_code::year || o.code == op_code::month || o.code == op_code::day || o.code == op_code::hour_12) {
+                    if (cur != end && (*cur == '-' || *cur == '+')) {
+                        negative = *cur++ == '-';
+                        --max_width;
+                    }
+                }
+                int value = 0;
+                unsigned count = 0;
+                for (; cur != end && count < max_width && *cur >= '0' && *cur <= '9'; ++cur, ++count)
+                    value = value * 10 + (*cur - '0');
+                if (o.code == op_code::second && count < max_width && cur != end && dubious(*cur))
+                    return verdict::undecided;
+                if (count < o.min_width)
+                    return verdict::mismatch;
+                if (negative)
+                    value = -value;
+
+                bool ok = true;
+                switch (o.code) {
+                    case op_code::year: ok = set(Y, value, not_a_year); break;
+                    case op_code::month:
+                    case op_code::unsigned_month: ok = set(m, value, not_a_month_or_day); break;
+                    case op_code::day:
+                    case op_code::unsigned_day: ok = set(d, value, not_a_month_or_day); break;
+                    case op_code::hour:
+                    case op_code::unsigned_hour: ok = set(H, value, not_a_hour_or_minute); break;
+                    case op_code::hour_12: ok = value >= 1 && value <= 12 && set(I, value, not_a_hour_12); break;
+                    case op_code::minute: ok = set(M, value, not_a_hour_or_minute); break;
+                    case op_code::second: ok = set(S, value, not_a_second); break;
+                    default: break;
+                }
+                if (!ok)
+                    return verdict::mismatch;
+            }
+
+            // no AM/PM here: a 12-hour clock value needs a consistent 24-hour one
+            if (I != not_a_hour_12) {
+                if (H == not_a_hour_or_minute)
+                    return verdict::mismatch;
+                if (I == 12 ? H != 0 && H != 12 : I != H && I != H + 12)
+                    return verdict::mismatch;
+            }
+            if (Y == not_a_year || m < 1 || d < 1)
+                return verdict::mismatch;
+            auto const ymd = date::year{Y} / date::month{static_cast<unsigned>(m)} / date::day{static_cast<unsigned>(d)};
+            if (!ymd.ok())
+                return verdict::mismatch;
+            H = H == not_a_hour_or_minute ? 0 : H;
+            M = M == not_a_hour_or_minute ? 0 : M;
+            S = S == not_a_second ? 0 : S;
+            if (H > 23 || M > 59 || S > 59)
+                return verdict::mismatch;
+            tp = date::sys_days{ymd} + std::chrono::hours{H} + std::chrono::minutes{M} + std::chrono::seconds{S};
+            return verdict::match;
+        }
+
+        /// The whole format has been compiled: date::parse() is never needed
+        [[nodiscard]] bool complete() const noexcept {
+            return complete_;
+        }
+
+    private:
+        enum class op_code : unsigned char {
+            literal,
+            spaces,
+            year,
+            month,
+            unsigned_month,
+            day,
+            unsigned_day,
+            hour,
+            unsigned_hour,
+            hour_12,
+            minute,
+            second,
+            undecided
+        };
+        struct op {
+            op_code code;
+            char ch;
+            unsigned char min_width;
+            unsigned char max_width;
+        };
+        std::array<op, 48> ops_ {};
+        std::size_t size_ {0};
+        std::size_t consumed_ {0};
+        bool complete_ {false};
+    };
+
+    /// Per-thread cache of compiled formats
+    inline strptime_program const & compiled_strptime_format(std::string const & fmt) {
+        thread_local std::deque<std::pair<std::string, strptime_program>> programs;
+        for (auto const & e : programs)
+            if (e.first == fmt)
+                return e.second;
+        return programs.emplace_back(fmt, strptime_program{fmt}).second;
+    }
+}
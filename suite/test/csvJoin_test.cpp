@@ -34,6 +34,9 @@ int main() {
         bool outer_join {false};
         bool check_integrity = {true};
         bool honest_outer_join = {false};
+        bool presorted {false};
+        std::string memory_limit;
+        std::string temp_dir;
     };
 
     "runs"_test = [] {
@@ -128,6 +131,20 @@ int main() {
                 notrimming_reader_type new_reader (cout_buffer.str());
                 expect(5 == new_reader.rows());
             }
+            {
+                // the stages go on with the row numbers of the files: line numbers count the printed rows only
+                auto args_copy = args;
+                args_copy.columns = "a";
+                args_copy.linenumbers = true;
+                args_copy.files = std::vector<std::string>{"examples/join_a.csv", "examples/join_b.csv", "examples/join_b.csv"};
+                CALL_TEST_AND_REDIRECT_TO_COUT(csvjoin::join_wrapper(args_copy))
+                expect(cout_buffer.str() == R"(line_number,a,b,c,b2,c2,b2_2,c2_2
+1,1,b,c,b,c,b,c
+2,1,b,c,b,c,b,c
+3,1,b,c,b,c,b,c
+4,1,b,c,b,c,b,c
+)");
+            }
 
             "max field size in this mode"_test = [&] {
                 auto args_copy = args;
@@ -153,6 +170,30 @@ int main() {
                 expect(cout_buffer.str() == R"(a,b,c,b2,b2_2
 )");
             };
+            "the smaller source is hashed"_test = [&] {
+                auto args_copy = args;
+                args_copy.columns = "a";
+                args_copy.files = std::vector<std::string>{"a,b\n1,x\n2,y\n", "a,c\n2,p\n1,q\n3,r\n1,s\n2,t\n"};
+                {
+                    CALL_TEST_AND_REDIRECT_TO_COUT(csvjoin::join_wrapper(args_copy, csvjoin::detail::csvjoin_source_option::csvjoin_string_source))
+                    expect(cout_buffer.str() == R"(a,b,c
+1,x,q
+1,x,s
+2,y,p
+2,y,t
+)");
+                }
+                std::swap(args_copy.files[0], args_copy.files[1]);
+                {
+                    CALL_TEST_AND_REDIRECT_TO_COUT(csvjoin::join_wrapper(args_copy, csvjoin::detail::csvjoin_source_option::csvjoin_string_source))
+                    expect(cout_buffer.str() == R"(a,c,b
+2,p,y
+1,q,x
+1,s,x
+2,t,y
+)");
+                }
+            };
         };
 
         "left"_test = [&] {
@@ -432,6 +473,30 @@ int main() {
             expect(throws([&] { csvjoin::join_wrapper(args_copy); }));
         };
 
+        "composite keys"_test = [&] {
+            auto args_copy = args;
+            args_copy.columns = "a+b,d+e";
+            args_copy.files = std::vector<std::string>{"a,b,c\n1,x,10\n1,y,20\n2,x,30\n", "d,e,f\n1,y,200\n2,x,300\n1,z,400\n"};
+            {
+                CALL_TEST_AND_REDIRECT_TO_COUT(csvjoin::join_wrapper(args_copy, csvjoin::detail::csvjoin_source_option::csvjoin_string_source))
+                expect(cout_buffer.str() == R"(a,b,c,f
+1,y,20,200
+2,x,30,300
+)");
+            }
+            {
+                args_copy.left_join = true;
+                CALL_TEST_AND_REDIRECT_TO_COUT(csvjoin::join_wrapper(args_copy, csvjoin::detail::csvjoin_source_option::csvjoin_string_source))
+                expect(cout_buffer.str() == R"(a,b,c,f
+1,x,10,
+1,y,20,200
+2,x,30,300
+)");
+            }
+            args_copy.columns = "a+b,d";
+            expect(throws([&] { csvjoin::join_wrapper(args_copy, csvjoin::detail::csvjoin_source_option::csvjoin_string_source); }));
+        };
+
         "csvjoin sequential/union strings"_test = [&] {
             auto args_copy = args;
             args_copy.files = std::vector<std::string>{"h1\nabc","h2\nabc\ndef","h3\n\nghi"};
@@ -644,5 +709,117 @@ True,2,,,,
 )");
             };
 
+        "presorted"_test = [&] {
+            auto args_copy = args;
+            args_copy.columns = "a";
+            args_copy.presorted = true;
+            args_copy.files = std::vector<std::string>{"a,b\n5,x\n6,y\n6,z\n8,w\n", "a,c\n6,p\n7,q\n8,r\n8,s\n"};
+            {
+                CALL_TEST_AND_REDIRECT_TO_COUT(csvjoin::join_wrapper(args_copy, csvjoin::detail::csvjoin_source_option::csvjoin_string_source))
+                expect(cout_buffer.str() == R"(a,b,c
+6,y,p
+6,z,p
+8,w,r
+8,w,s
+)");
+            }
+            {
+                auto left_args = args_copy;
+                left_args.left_join = true;
+                CALL_TEST_AND_REDIRECT_TO_COUT(csvjoin::join_wrapper(left_args, csvjoin::detail::csvjoin_source_option::csvjoin_string_source))
+                expect(cout_buffer.str() == R"(a,b,c
+5,x,
+6,y,p
+6,z,p
+8,w,r
+8,w,s
+)");
+            }
+            {
+                auto outer_args = args_copy;
+                outer_args.outer_join = true;
+                CALL_TEST_AND_REDIRECT_TO_COUT(csvjoin::join_wrapper(outer_args, csvjoin::detail::csvjoin_source_option::csvjoin_string_source))
+                expect(cout_buffer.str() == R"(a,b,a2,c
+5,x,,
+6,y,6,p
+6,z,6,p
+,,7,q
+8,w,8,r
+8,w,8,s
+)");
+            }
+            args_copy.files[1] = "a,c\n7,q\n6,p\n";
+            std::stringstream cout_buffer;
+            redirect(cout)
+            redirect_cout cr(cout_buffer.rdbuf());
+            expect(throws([&] { csvjoin::join_wrapper(args_copy, csvjoin::detail::csvjoin_source_option::csvjoin_string_source); }));
+        };
+
+        "memory limit"_test = [&] {
+            // the rows come partition by partition: the lines are compared in order
+            auto sorted_lines = [](std::string const & output) {
+                std::istringstream is(output);
+                std::vector<std::string> lines;
+                for (std::string line; std::getline(is, line);)
+                    lines.push_back(line);
+                std::sort(lines.begin() + 1, lines.end());
+                return lines;
+            };
+            for (auto files : {std::vector<std::string>{"examples/join_a.csv", "examples/join_b.csv"}
+                             , std::vector<std::string>{"examples/join_a.csv", "examples/join_b.csv", "examples/join_b.csv"}}) {
+                for (auto kind : {"inner", "left", "right", "outer"}) {
+                    auto args_copy = args;
+                    args_copy.columns = "a";
+                    args_copy.files = files;
+                    args_copy.left_join = kind == std::string("left");
+                    args_copy.right_join = kind == std::string("right");
+                    args_copy.outer_join = kind == std::string("outer");
+                    std::string in_memory;
+                    {
+                        CALL_TEST_AND_REDIRECT_TO_COUT(csvjoin::join_wrapper(args_copy))
+                        in_memory = cout_buffer.str();
+                    }
+                    {
+                        // a join within the limit is made in memory, the rows are not reordered
+                        args_copy.files = files;
+                        args_copy.memory_limit = "1G";
+                        CALL_TEST_AND_REDIRECT_TO_COUT(csvjoin::join_wrapper(args_copy))
+                        expect(cout_buffer.str() == in_memory);
+                    }
+                    args_copy.files = files;
+                    args_copy.memory_limit = "1";
+                    CALL_TEST_AND_REDIRECT_TO_COUT(csvjoin::join_wrapper(args_copy))
+                    expect(sorted_lines(cout_buffer.str()) == sorted_lines(in_memory));
+                }
+            }
+
+            // the last of three files alone exceeds the limit, the first two do not: the joins are partitioned
+            std::string large = "a,d\n";
+            for (auto i = 0; i < 5000; ++i)
+                large += std::to_string(i % 7) + ',' + std::to_string(i) + '\n';
+            auto args_copy = args;
+            args_copy.columns = "a";
+            args_copy.files = std::vector<std::string>{"a,b\n1,x\n2,y\n", "a,c\n2,q\n1,p\n", large};
+            std::string in_memory;
+            {
+                CALL_TEST_AND_REDIRECT_TO_COUT(csvjoin::join_wrapper(args_copy, csvjoin::detail::csvjoin_source_option::csvjoin_string_source))
+                in_memory = cout_buffer.str();
+            }
+            expect(std::count(in_memory.begin(), in_memory.end(), '\n') == 1 + 715 + 714); // the header, keys 1 and 2
+            args_copy.files = std::vector<std::string>{"a,b\n1,x\n2,y\n", "a,c\n2,q\n1,p\n", large};
+            args_copy.memory_limit = "16K";
+            {
+                // no partition file can be written to a missing directory
+                auto missing_dir_copy = args_copy;
+                missing_dir_copy.temp_dir = "no such directory";
+                std::stringstream cout_buffer;
+                redirect(cout)
+                redirect_cout cr(cout_buffer.rdbuf());
+                expect(throws([&] { csvjoin::join_wrapper(missing_dir_copy, csvjoin::detail::csvjoin_source_option::csvjoin_string_source); }));
+            }
+            CALL_TEST_AND_REDIRECT_TO_COUT(csvjoin::join_wrapper(args_copy, csvjoin::detail::csvjoin_source_option::csvjoin_string_source))
+            expect(sorted_lines(cout_buffer.str()) == sorted_lines(in_memory));
+        };
+
     };
 }
@@ -30,6 +30,10 @@ int main() {
         bool r {false};
         bool ignore_case {false};
         bool parallel_sort {true};
+        std::string memory_limit;
+        std::string temp_dir;
+        unsigned long head {0};
+        unsigned long tail {0};
     };
 
     struct csvSort_args : tf::single_file_arg, tf::common_args, tf::type_aware_args, tf::spread_args, tf::output_args, csvsort_specific_args {};
@@ -128,6 +132,238 @@ int main() {
 )");
     };
 
+    "equal keys keep input order"_test = [] {
+        namespace tf = csvsuite::test_facilities;
+        struct Args : csvSort_args {
+            Args() { file = "examples/test_ignore_case.csv"; columns = "1"; }
+        } args;
+
+        CALL_TEST_AND_REDIRECT_TO_COUT(csvsort::sort)
+
+        expect(cout_buffer.str() == R"(a,b,c
+3,2009-01-01,d
+20,2002-01-01,b
+20,2001-01-01,c
+100,2003-01-01,a
+100,2003-01-01,A
+)");
+    };
+
+    "chunks printed concurrently as the serial printer prints the rows"_test = [] {
+        using namespace ::csvsuite::cli::compare;
+        struct Args : csvSort_args {} args;
+
+        // booleans and numbers over many chunks of 4096 rows
+        std::string csv = "b,n\n";
+        auto const rows = 5 * 4096 + 17;
+        for (std::size_t i = 0; i < rows; ++i)
+            csv += std::string(i % 3 ? "true" : "false") + ',' + std::to_string(i * 7919 % 1000) + '\n';
+
+        notrimming_reader_type reader(csv);
+        auto const types_blanks = std::get<1>(typify(reader, args, typify_option::typify_without_precisions));
+        expect(std::get<0>(types_blanks) == std::vector{column_type::bool_t, column_type::number_t});
+        cell_arena_MxN table(reader, args);
+
+        std::vector<std::size_t> order(table.rows());
+        std::iota(order.rbegin(), order.rend(), 0);
+
+        std::ostringstream concurrent;
+        csvsort::printer(concurrent).write(table, order, types_blanks, args);
+
+        std::ostringstream serial;
+        csvsort::printer serial_printer(serial);
+        for (auto r : order) {
+            serial_printer.write_cells(table[r], types_blanks, args);
+            print_LF(serial);
+        }
+        expect(concurrent.str() == serial.str());
+        expect(serial.str().starts_with(std::string((rows - 1) % 3 ? "True," : "False,") + std::to_string((rows - 1) * 7919 % 1000) + '\n'));
+        expect(serial.str().ends_with("False,0\n"));
+    };
+
+    "binary keys order as the comparators do"_test = [] {
+        using namespace ::csvsuite::cli::compare;
+        struct Args : csvSort_args {
+            Args() { date_fmt = "%Y-%m-%d"; }
+        } args;
+
+        notrimming_reader_type reader("n,d,t\n-10.5,2001-03-04,apple\n3,,Banana\n,1999-12-31,apple\n-2,2001-03-04,\n"
+                                      "0,2020-01-01,Zeta\n-10.5,,banana\n-0.25,1999-12-31,Äpfel\n3,2001-03-04,APPLE\n,,\n"
+                                      "-1000,2020-01-01,zeta\n0.5,1999-12-31,äpfel\n-2,,apple pie\n");
+        using element_t = typed_span_t<notrimming_reader_type>;
+        auto const types_blanks = std::get<1>(typify(reader, args, typify_option::typify_without_precisions));
+        auto const & [types, blanks] = types_blanks;
+        expect(types == std::vector{column_type::number_t, column_type::date_t, column_type::text_t});
+        expect(blanks[0] && blanks[1] && blanks[2]);
+        compromise_table_MxN table(reader, args);
+
+        for (auto descending : {false, true}) {
+            for (auto ignore_case : {false, true}) {
+                for (auto const & ids : std::vector<std::vector<unsigned>>{{0}, {1}, {2}, {0, 2}, {1, 0}, {2, 1, 0}}) {
+                    args.r = descending;
+                    args.ignore_case = ignore_case;
+                    csvsort::setup_string_comparison_type(reader, args);
+
+                    std::vector<std::size_t> expected(table.rows());
+                    std::iota(expected.begin(), expected.end(), 0);
+                    auto const compare_fun = obtain_compare_functionality<element_t>(ids, types_blanks, args);
+                    sort_comparator less_cmp(compare_fun, std::less<>());
+                    sort_comparator greater_cmp(compare_fun, std::greater<>());
+                    std::stable_sort(expected.begin(), expected.end(), [&](auto a, auto b) {
+                        return descending ? greater_cmp(table[a], table[b]) : less_cmp(table[a], table[b]);
+                    });
+
+                    std::vector<typed_column> key_columns;
+                    for (auto id : ids)
+                        key_columns.emplace_back(table, id, types[id], blanks[id], args);
+                    expect(sorted_rows(sort_keys(key_columns, table.rows(), descending), false) == expected);
+                    if (csvsort::single_radix_key(key_columns))
+                        expect(radix_sorted_rows(key_columns[0], table.rows(), descending, false) == expected);
+                }
+            }
+        }
+        args.ignore_case = false;
+        csvsort::setup_string_comparison_type(reader, args);
+    };
+
+    "NaN keys follow every number"_test = [] {
+        using namespace ::csvsuite::cli::compare;
+        struct Args : csvSort_args {} args;
+
+        notrimming_reader_type reader("n\nNaN\n2\n-Infinity\nnan\nInfinity\n-0.5\n0\n");
+        auto const types_blanks = std::get<1>(typify(reader, args, typify_option::typify_without_precisions));
+        expect(std::get<0>(types_blanks)[0] == column_type::number_t);
+        cell_arena_MxN table(reader, args);
+
+        std::vector<typed_column> key_columns;
+        key_columns.emplace_back(table, 0, column_type::number_t, std::get<1>(types_blanks)[0], args);
+        auto const & column = key_columns[0];
+        // a strict weak ordering, the one of the binary keys
+        for (std::size_t a = 0; a < table.rows(); ++a) {
+            for (std::size_t b = 0; b < table.rows(); ++b) {
+                auto const result = column.compare(a, b);
+                expect(result == -column.compare(b, a));
+                sort_keys const keys(key_columns, table.rows(), false);
+                auto const key_result = keys[a].compare(keys[b]);
+                expect((result < 0) == (key_result < 0) && (result > 0) == (key_result > 0));
+            }
+        }
+        std::vector<std::size_t> const ascending {2, 5, 6, 1, 4, 0, 3};
+        std::vector<std::size_t> const descending {0, 3, 4, 1, 6, 5, 2};
+        expect(sorted_rows(sort_keys(key_columns, table.rows(), false), false) == ascending);
+        expect(sorted_rows(sort_keys(key_columns, table.rows(), true), false) == descending);
+        expect(radix_sorted_rows(column, table.rows(), false, false) == ascending);
+        expect(radix_sorted_rows(column, table.rows(), true, false) == descending);
+    };
+
+    "memory limit"_test = [] {
+        namespace tf = csvsuite::test_facilities;
+        struct Args : csvSort_args {
+            Args() { file = "examples/test_ignore_case.csv"; columns = "1"; memory_limit = "100"; }
+        } args;
+
+        CALL_TEST_AND_REDIRECT_TO_COUT(csvsort::sort)
+
+        // single-row runs are merged into the order the in-memory sort gives
+        expect(cout_buffer.str() == R"(a,b,c
+3,2009-01-01,d
+20,2002-01-01,b
+20,2001-01-01,c
+100,2003-01-01,a
+100,2003-01-01,A
+)");
+    };
+
+    "memory limit with more runs than are merged at a time"_test = [] {
+        struct Args : csvSort_args {
+            Args() { columns = "1"; }
+        } args;
+
+        // single-row runs, merged into longer runs first
+        std::string csv = "a,b\n";
+        auto const rows = 3 * csvsort::detail::merge_fan_in + 5;
+        for (std::size_t i = 0; i < rows; ++i)
+            csv += std::to_string(i * 7919 % 50) + ',' + std::to_string(i) + '\n';
+
+        auto sorted = [&] {
+            std::stringstream cout_buffer;
+            {
+                redirect(cout)
+                redirect_cout cr(cout_buffer.rdbuf());
+                notrimming_reader_type r(csv);
+                csvsort::sort(r, args);
+            }
+            return cout_buffer.str();
+        };
+        auto const in_memory = sorted();
+        args.memory_limit = "100";
+        expect(sorted() == in_memory);
+        expect(std::count(in_memory.begin(), in_memory.end(), '\n') == static_cast<std::ptrdiff_t>(rows + 1));
+        args.tail = 7;
+        auto tail_start = in_memory.size() - 1;
+        for (auto line = 0; line < 7; ++line)
+            tail_start = in_memory.rfind('\n', tail_start - 1);
+        expect(sorted() == "a,b\n" + in_memory.substr(tail_start + 1));
+    };
+
+    "memory limit counts the key bytes"_test = [] {
+        using namespace ::csvsuite::cli::compare;
+        struct Args : csvSort_args {} args;
+
+        notrimming_reader_type reader("a,b\n1," + std::string(1000, 'x') + "\n2,y\n");
+        cell_arena_MxN table(reader, args);
+        std::vector<unsigned> const text_key {1};
+        std::vector<unsigned> const number_key {0};
+        auto const wide = csvsort::detail::run_row_bytes(table[0], text_key, args);
+        expect(wide > 1000);
+        expect(wide - csvsort::detail::run_row_bytes(table[1], text_key, args) == 999);
+        expect(csvsort::detail::run_row_bytes(table[0], number_key, args) < 1000);
+        args.ignore_case = true;
+        expect(csvsort::detail::run_row_bytes(table[0], text_key, args) > 2000);
+
+        // runs of wide keys are cut by their bytes, not by their rows
+        args.ignore_case = false;
+        args.columns = "2";
+        std::string csv = "a,b\n";
+        for (auto i = 0; i < 200; ++i)
+            csv += std::to_string(i) + ',' + std::string(500, static_cast<char>('a' + i * 7 % 26)) + '\n';
+        auto sorted = [&] {
+            std::stringstream cout_buffer;
+            {
+                redirect(cout)
+                redirect_cout cr(cout_buffer.rdbuf());
+                notrimming_reader_type r(csv);
+                csvsort::sort(r, args);
+            }
+            return cout_buffer.str();
+        };
+        auto const in_memory = sorted();
+        args.memory_limit = "8K";
+        expect(sorted() == in_memory);
+    };
+
+    "head and tail"_test = [] {
+        namespace tf = csvsuite::test_facilities;
+        struct Args : csvSort_args {
+            Args() { file = "examples/test_ignore_case.csv"; columns = "1"; }
+        } args;
+
+        {
+            args.head = 3;
+            CALL_TEST_AND_REDIRECT_TO_COUT(csvsort::sort)
+            expect(cout_buffer.str() == "a,b,c\n3,2009-01-01,d\n20,2002-01-01,b\n20,2001-01-01,c\n");
+        }
+        {
+            args.head = 0;
+            args.tail = 2;
+            args.memory_limit = "100";
+            CALL_TEST_AND_REDIRECT_TO_COUT(csvsort::sort)
+            expect(cout_buffer.str() == "a,b,c\n100,2003-01-01,a\n100,2003-01-01,A\n");
+        }
+        args.head = 1;
+        expect(throws([&] { CALL_TEST_AND_REDIRECT_TO_COUT(csvsort::sort) }));
+    };
+
     "no blanks"_test = [] {
         namespace tf = csvsuite::test_facilities;
         struct Args : csvSort_args {
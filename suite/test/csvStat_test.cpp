@@ -58,6 +58,7 @@ int main() {
         unsigned long freq_count {5ul};
         bool count {false};
         bool no_mdp {false};
+        bool streaming {false};
         bool no_grouping_sep {false};
         std::string decimal_format {"%.3f"};
     };
@@ -322,6 +323,56 @@ Decode error: simdutf can't decode byte 0xa9 in position 16.
                             });
     };
 
+    "long column"_test = [] {
+        struct Args : csvStat_args {
+            Args() {
+                csv = true;
+                columns = "1,2";
+            }
+        } args;
+
+        // long enough to be aggregated in chunks
+        std::string csv = "a,b\n";
+        for (auto i = 0; i < 300000; ++i)
+            csv += (i % 10 == 9 ? std::string{} : std::to_string(i % 1000)) + ",x" + std::to_string(i % 3) + '\n';
+        notrimming_reader_type r(csv);
+
+        TEST_NO_THROW
+
+        notrimming_reader_type csv_reader(cout_buffer.str());
+        int crow = 1;
+        csv_reader.run_rows([](auto &) {}, [&](auto &row) {
+            using cell_type = notrimming_reader_type::typed_span<csv_co::unquoted>;
+            if (crow++ == 1) {
+                expect(cell_type(row[2]).str() == "Number");
+                expect(cell_type(row[4]).num() == 270000);
+                expect(cell_type(row[5]).num() == 901);
+                expect(cell_type(row[6]).num() == 0);
+                expect(cell_type(row[7]).num() == 998);
+                expect(cell_type(row[8]).num() == 134730000);
+                expect(cell_type(row[9]).num() == 499);
+                expect(cell_type(row[10]).num() == 499);
+            } else {
+                expect(cell_type(row[2]).str() == "Text");
+                expect(cell_type(row[4]).num() == 300000);
+                expect(cell_type(row[5]).num() == 3);
+                expect(cell_type(row[12]).num() == 2);
+            }
+        });
+    };
+
+    "median"_test = [] {
+        struct Args : csvStat_args {
+            Args() { median = true; }
+        } args;
+
+        notrimming_reader_type r("a\n3\n\n1\n4\n\n2\n");
+
+        TEST_NO_THROW
+
+        expect(cout_buffer.str().find("2.5") != std::string::npos);
+    };
+
     "json"_test = [] {
         using namespace rapidjson;
 
@@ -357,6 +408,56 @@ Decode error: simdutf can't decode byte 0xa9 in position 16.
         }
     };
 
+    "streaming"_test = [] {
+        using namespace rapidjson;
+
+        struct Args : csvStat_args {
+            Args() {
+                file = "examples/ks_1033_data.csv";
+                json = true;
+            }
+        } args;
+
+        auto run = [&](auto & r) {
+            TEST_NO_THROW
+            Document document;
+            document.Parse(cout_buffer.str().c_str());
+            expect(!document.HasParseError());
+            return document;
+        };
+
+        {
+            // too few values to estimate anything: the same statistics, most common values aside (ties may go otherwise)
+            notrimming_reader_type r(args.file);
+            auto const exact = run(r);
+            args.streaming = true;
+            notrimming_reader_type r2(args.file);
+            auto const streamed = run(r2);
+            expect(exact.GetArray().Size() == streamed.GetArray().Size());
+            for (SizeType c = 0; c < exact.GetArray().Size(); ++c) {
+                for (auto const & m : exact[c].GetObject()) {
+                    if (std::string(m.name.GetString()) != "freq")
+                        expect(streamed[c].HasMember(m.name) && streamed[c][m.name] == m.value);
+                }
+                expect(!streamed[c].HasMember("approximate"));
+            }
+        }
+        {
+            args.columns = "1";
+            std::string csv = "a\n";
+            for (auto i = 0; i < 300000; ++i)
+                csv += (i % 10 == 9 ? std::string{} : std::to_string(i % 1000)) + '\n';
+            notrimming_reader_type r(csv);
+            auto const streamed = run(r);
+            auto const & e = streamed[0];
+            expect(e["sum"].GetDouble() == 134730000);
+            expect(e["mean"].GetDouble() == 499);
+            expect(e["unique"].GetInt() == 901);
+            expect(e["median"].GetDouble() >= 498 && e["median"].GetDouble() <= 500);
+            expect(e["approximate"].GetArray().Size() == 1 && std::string(e["approximate"][0].GetString()) == "median");
+        }
+    };
+
     "json_columns"_test = [] {
         using namespace rapidjson;
 
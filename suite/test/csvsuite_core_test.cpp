@@ -11,6 +11,7 @@
 #include "common_args.h"
 #include <cli-compare.h>
 #include <cli-hash.h>
+#include <cli-sketch.h>
 
 int main() {
     using namespace boost::ut;
@@ -1090,6 +1091,108 @@ Either use/reuse the -K option for alignment, or use the csvClean utility to fix
         }
     };
 
+    "typify tall table by row chunks"_test = [&] {
+        struct args : common_args, type_aware_args {} a;
+
+        std::string csv {"h1,h2,h3\n"};
+        auto const rows = min_inference_chunk * 8;
+        for (auto i = 0u; i < rows; i++)
+            csv += (i == rows - 1 ? std::string{"12.12345"} : std::to_string(i % 100) + ".1") + ',' + (i == rows / 2 ? "" : "T") + ',' + (i == rows - 2 ? "text" : "1.12") + '\n';
+
+        notrimming_reader_type r(csv);
+        auto [types, blanks, precisions] = std::get<0>(typify(r, a, typify_option::typify_with_precisions));
+        expect(types[0] == column_type::number_t && types[1] == column_type::bool_t && types[2] == column_type::text_t);
+        expect(!blanks[0] && blanks[1] && !blanks[2]);
+        expect(precisions[0] == 5 && precisions[1] == 0 && precisions[2] == 2);
+    };
+
+    "typify row chunks as a sequential pass"_test = [&] {
+        struct args : common_args, type_aware_args {} a;
+
+        // a bool value is never tested as a bool once the column has a number, be it at the start of a later chunk
+        std::string csv {"h1,h2\n"};
+        auto const rows = min_inference_chunk * 8;
+        for (auto i = 0u; i < rows; i++)
+            csv += std::string(i && !(i % (rows / 8)) ? "yes" : "5") + ',' + (i < rows / 2 ? "yes" : "T") + '\n';
+
+        notrimming_reader_type r(csv);
+        auto [types, blanks] = std::get<1>(typify(r, a, typify_option::typify_without_precisions));
+        expect(types[0] == column_type::text_t);
+        expect(types[1] == column_type::bool_t);
+    };
+
+    "typify by first rows"_test = [&] {
+        struct args : common_args, type_aware_args {
+            std::size_t infer_rows = 2;
+        } a;
+
+        notrimming_reader_type r("h1,h2,h3,h4,h5\n1,T,,1,0\n2,F,,2,1\n3,text,5,,2\n4,T,,2.5,1\n");
+        auto [types, blanks] = std::get<1>(typify(r, a, typify_option::typify_without_precisions));
+        expect(types[0] == column_type::number_t);
+        expect(types[1] == column_type::text_t); // demoted by a value after the sample
+        expect(types[2] == column_type::number_t); // a sample of nulls only is inferred in full
+        expect(types[3] == column_type::number_t);
+        expect(types[4] == column_type::number_t); // a bool sample falls back to the number it could be as well
+        expect(!blanks[0] && !blanks[1] && blanks[2] && blanks[3] && !blanks[4]);
+    };
+
+    "strptime program"_test = [] {
+        using csv_co::csvsuite::strptime_program;
+        using verdict = strptime_program::verdict;
+        date::sys_seconds tp;
+
+        strptime_program const datetime_prog("%Y-%m-%d %H:%M:%S");
+        expect(datetime_prog.complete());
+        expect(datetime_prog("2023-1-2 3:04:05", tp) == verdict::match);
+        expect(tp == date::sys_days{date::year{2023}/1/2} + std::chrono::hours{3} + std::chrono::minutes{4} + std::chrono::seconds{5});
+        expect(datetime_prog("2023-02-29 00:00:00", tp) == verdict::mismatch);
+        expect(datetime_prog("2023-01-02 24:00:00", tp) == verdict::mismatch);
+        expect(datetime_prog("2023-01-02 10:00:5.5", tp) == verdict::undecided); // a decimal point depends on locale
+
+        strptime_program const date_prog("%d/%m/%Y");
+        expect(date_prog("28/02/2023 and the rest", tp) == verdict::match);
+        expect(date_prog("28-02-2023", tp) == verdict::mismatch);
+
+        strptime_program const ampm_prog("%m/%d/%Y %I:%M %p");
+        expect(!ampm_prog.complete());
+        expect(ampm_prog("02/28/2023 08:08 AM", tp) == verdict::undecided);
+        expect(ampm_prog("02/28/2023 08-08 AM", tp) == verdict::mismatch);
+
+        // formats too long to be compiled in full leave the rest to date::parse()
+        strptime_program const long_prog("%d/%m/%Y" + std::string(50, '-'));
+        expect(!long_prog.complete());
+        expect(long_prog("28/02/2023" + std::string(43, '-') + "xxxxxxx", tp) == verdict::undecided);
+        strptime_program const long_directive_prog(std::string(45, '-') + "%F");
+        expect(!long_directive_prog.complete());
+        expect(long_directive_prog(std::string(45, '-') + "2023-01-02", tp) == verdict::undecided);
+    };
+
+    "literal set"_test = [] {
+        using csv_co::csvsuite::literal_set;
+        literal_set const set {"NA", "n/a", "None", "TRUE", "infinity"};
+        expect(set.contains("na"));
+        expect(set.contains("N/A"));
+        expect(set.contains("nONe"));
+        expect(set[set.find("true")] == "TRUE");
+        expect(set.find("Infinity") != literal_set::npos);
+        expect(!set.contains("NAN"));
+        expect(!set.contains("TRU"));
+        expect(!set.contains(""));
+        expect(!set.contains(" NA"));
+
+        cell_string cs = "  yes ";
+        expect(reader<>::typed_span<unquoted>{reader<>::cell_span{cs}}.is_boolean());
+        cs = "\"No\"";
+        expect(reader<>::typed_span<unquoted>{reader<>::cell_span{cs}}.is_boolean());
+        expect(not reader<>::typed_span<quoted>{reader<>::cell_span{cs}}.is_boolean());
+        cs = "\"0\"";
+        expect(reader<>::typed_span<quoted>{reader<>::cell_span{cs}}.is_boolean());
+        cs = "-Inf";
+        expect(reader<>::typed_span<unquoted>{reader<>::cell_span{cs}}.num() == -INFINITY);
+        cs = "n/A";
+        expect(reader<>::typed_span<unquoted>{reader<>::cell_span{cs}}.is_null());
+    };
+
     "mix rows and run_rows"_test = [] {
         struct Args : common_args, type_aware_args, single_file_arg {
             std::size_t skip_lines = 2;
@@ -1205,4 +1308,76 @@ Either use/reuse the -K option for alignment, or use the csvClean utility to fix
             });
         }
     };
+
+    "typed key columns find equal keys as the comparators do"_test = [&] {
+        using namespace ::csvsuite::cli::compare;
+
+        struct args : common_args, type_aware_args {} a;
+        for (auto no_inference : {false, true}) {
+            a.no_inference = no_inference;
+            notrimming_reader_type r("n,t\n10.5,x\nNaN,x \n,\n 10.50 ,X\nnan,x\n-0,\n0,x\n");
+            auto const types_blanks = std::get<1>(typify(r, a, typify_option::typify_without_precisions));
+            cell_arena_MxN table(r, a);
+            for (auto column : {0u, 1u}) {
+                using element_t = typed_span_t<notrimming_reader_type>;
+                typed_column const key_column(table, column, std::get<0>(types_blanks)[column], std::get<1>(types_blanks)[column], a);
+                auto const compare = std::get<1>(obtain_compare_functionality<element_t>(column, types_blanks, a));
+                for (std::size_t r1 = 0; r1 < table.rows(); ++r1) {
+                    for (std::size_t r2 = 0; r2 < table.rows(); ++r2) {
+                        int result;
+                        std::visit([&](auto & f) { result = f(table[r1][column], table[r2][column]); }, compare);
+                        expect(key_column.equal(r1, r2) == !result);
+                        expect(key_column.equal(table[r1][column], r2) == !result);
+                    }
+                }
+            }
+        }
+    };
+
+    "blocked bloom filter"_test = [] {
+        using namespace ::csvsuite::cli::hash;
+        blocked_bloom_filter filter(10000);
+        for (std::uint64_t i = 0; i < 10000; ++i)
+            filter.insert(spread_hash(i));
+        bool all_found = true;
+        for (std::uint64_t i = 0; i < 10000; ++i)
+            all_found = all_found && filter.may_contain(spread_hash(i));
+        expect(all_found);
+        std::size_t false_positives = 0;
+        for (std::uint64_t i = 10000; i < 110000; ++i)
+            false_positives += filter.may_contain(spread_hash(i));
+        expect(false_positives < 1000);
+    };
+
+    "sketches"_test = [] {
+        using namespace ::csvsuite::cli::sketch;
+        distinct_counter<long> distinct;
+        for (long i = 0; i < 200000; ++i) {
+            distinct.add(i % 1000);
+            if (i == 1000)
+                expect(distinct.exact() && distinct.count() == 1000);
+        }
+        for (long i = 0; i < 200000; ++i)
+            distinct.add(i);
+        expect(!distinct.exact());
+        expect(distinct.count() > 196000 && distinct.count() < 204000);
+
+        frequent_values<long> frequent(100);
+        for (long i = 0; i < 100000; ++i)
+            frequent.add(i % 4 ? i : 7);
+        expect(!frequent.exact());
+        auto const counts = frequent.counts();
+        auto const top = std::max_element(counts.begin(), counts.end(), [](auto & a, auto & b) { return a.second < b.second; });
+        expect(top->first == 7 && top->second >= 25000);
+
+        quantile_sketch<double> exact;
+        for (double v : {5.0, 1.0, 4.0, 2.0})
+            exact.add(v);
+        expect(exact.exact() && exact.median() == 3.0);
+        quantile_sketch<double> estimated;
+        for (long i = 0; i < 1000000; ++i)
+            estimated.add(static_cast<double>((i * 7919) % 1000000));
+        expect(!estimated.exact());
+        expect(std::abs(estimated.median() - 500000) < 10000);
+    };
 }
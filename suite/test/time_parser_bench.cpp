@@ -0,0 +1,32 @@
+///
+/// \file   suite/test/time_parser_bench.cpp
+/// \author wiluite
+/// \brief  Per-cell cost of the timedelta parser.
+
+#include <cli.h>
+#include <chrono>
+#include <iostream>
+
+int main(int argc, char * argv[]) {
+    using namespace csv_co;
+    std::size_t const rounds = argc > 1 ? std::stoul(argv[1]) : 200000;
+
+    std::array<std::string_view, 10> const cells {
+        "1 day, 2:03:04", "4:05:06.789", "3 days, 10:11:12", "1:02", "45s", "1w 2d 3h 4m 5s"
+        , "2.5 hours", "10 mins 20 secs", "not a timedelta", "17 weeks 3 days"
+    };
+
+    std::size_t parsed = 0;
+    auto const start = std::chrono::steady_clock::now();
+    for (std::size_t r = 0; r < rounds; ++r) {
+        for (auto cell : cells) {
+            time_parser t_parser;
+            if (t_parser.parse(cell))
+                parsed += t_parser.str().size();
+        }
+    }
+    auto const elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "time_parser: " << elapsed / static_cast<double>(rounds * cells.size()) << " ns per cell ("
+              << parsed << " characters formatted)\n";
+}